@@ -0,0 +1,113 @@
+#ifndef V8PP_BENCH_HPP_INCLUDED
+#define V8PP_BENCH_HPP_INCLUDED
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+#include "v8pp/context.hpp"
+
+/// Benchmark runner, measures each case several times
+/// and reports results as JSON lines, one object per case:
+/// {"group":"call","name":"free_function_0","iterations":N,"repeats":R,"min_ns":..,"median_ns":..,"max_ns":..}
+/// Times are per single iteration.
+class bench_runner
+{
+public:
+	struct result
+	{
+		std::string group;
+		std::string name;
+		uint64_t iterations;
+		std::vector<double> samples; ///< nanoseconds per iteration of each repeat
+	};
+
+	bench_runner()
+		: repeats_(7)
+		, scale_(1.0)
+		, os_(nullptr)
+	{
+	}
+
+	/// Number of repeats for each case, median is reported
+	void set_repeats(size_t repeats) { repeats_ = std::max<size_t>(repeats, 1); }
+
+	/// Multiplier for iteration counts
+	void set_scale(double scale) { scale_ = scale > 0 ? scale : 1.0; }
+
+	/// Run only cases with group.name starting with the filter
+	void set_filter(std::string const& filter) { filter_ = filter; }
+
+	/// Run a benchmark case. body(n) performs n iterations,
+	/// one warm-up run precedes measurements
+	template<typename Body>
+	void run(char const* group, char const* name, uint64_t iterations, Body body)
+	{
+		std::string const full_name = std::string(group) + "." + name;
+		if (full_name.compare(0, filter_.size(), filter_) != 0)
+		{
+			return;
+		}
+
+		iterations = std::max<uint64_t>(static_cast<uint64_t>(iterations * scale_), 1);
+
+		result res;
+		res.group = group;
+		res.name = name;
+		res.iterations = iterations;
+
+		body(std::max<uint64_t>(iterations / 10, 1));
+		for (size_t i = 0; i < repeats_; ++i)
+		{
+			auto const start = std::chrono::steady_clock::now();
+			body(iterations);
+			auto const elapsed = std::chrono::steady_clock::now() - start;
+			res.samples.push_back(
+				std::chrono::duration<double, std::nano>(elapsed).count() / iterations);
+		}
+		report(res);
+		results_.push_back(std::move(res));
+	}
+
+	std::vector<result> const& results() const { return results_; }
+
+	/// Stream for results, nothing is written if not set
+	void set_output(std::ostream* os) { os_ = os; }
+
+private:
+	void report(result const& res) const;
+
+	size_t repeats_;
+	double scale_;
+	std::string filter_;
+	std::ostream* os_;
+	std::vector<result> results_;
+};
+
+/// Compile a JavaScript function `function(n) { for (var i = 0; i < n; ++i) { body } }`
+/// with optional setup code before the loop
+v8::Local<v8::Function> js_loop(v8pp::context& context, char const* body, char const* setup = "");
+
+/// Call function made by js_loop()
+void run_js_loop(v8pp::context& context, v8::Local<v8::Function> loop, uint64_t n);
+
+/// Optimization barrier for benchmark results
+template<typename T>
+inline void do_not_optimize(T const& value)
+{
+	static void const* volatile sink;
+	sink = &value;
+}
+
+void bench_call(bench_runner& runner);
+void bench_convert(bench_runner& runner);
+void bench_call_v8(bench_runner& runner);
+void bench_function(bench_runner& runner);
+void bench_wrap(bench_runner& runner);
+void bench_gc(bench_runner& runner);
+void bench_context(bench_runner& runner);
+
+#endif // V8PP_BENCH_HPP_INCLUDED
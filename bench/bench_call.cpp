@@ -0,0 +1,153 @@
+#include "v8pp/class.hpp"
+#include "v8pp/context.hpp"
+#include "v8pp/interceptors.hpp"
+#include "v8pp/module.hpp"
+#include "v8pp/property.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+int f0() { return 0; }
+int f1(int a) { return a; }
+int f2(int a, int b) { return a + b; }
+int f3(int a, int b, int c) { return a + b + c; }
+int f4(int a, int b, int c, int d) { return a + b + c + d; }
+int f5(int a, int b, int c, int d, int e) { return a + b + c + d + e; }
+int f6(int a, int b, int c, int d, int e, int f) { return a + b + c + d + e + f; }
+int f7(int a, int b, int c, int d, int e, int f, int g) { return a + b + c + d + e + f + g; }
+int f8(int a, int b, int c, int d, int e, int f, int g, int h) { return a + b + c + d + e + f + g + h; }
+
+int global_value = 0;
+int get_global() { return global_value; }
+void set_global(int value) { global_value = value; }
+
+struct point
+{
+	int x = 0;
+	int y = 0;
+
+	int get_x() const { return x; }
+	void set_x(int value) { x = value; }
+
+	int sum(int z) const { return x + y + z; }
+	void move(int dx, int dy) { x += dx; y += dy; }
+
+	int at(unsigned int index) { return index ? y : x; }
+};
+
+// Record with named fields, separate classes with
+// and without hot keys promoted to accessors
+template<bool Promoted>
+struct record
+{
+	int x = 1;
+	int y = 2;
+
+	int field(v8pp::string_view name) { return name == "x" ? x : y; }
+	void set_field(v8pp::string_view name, int value) { (name == "x" ? x : y) = value; }
+
+	static bool stable_key(v8pp::string_view) { return true; }
+};
+
+using plain_record = record<false>;
+using hot_record = record<true>;
+
+} // unnamed namespace
+
+void bench_call(bench_runner& runner)
+{
+	v8pp::context context;
+	v8::Isolate* isolate = context.isolate();
+	v8::HandleScope scope(isolate);
+
+	v8pp::module functions(isolate);
+	functions
+		.set("f0", &f0)
+		.set("f1", &f1)
+		.set("f2", &f2)
+		.set("f3", &f3)
+		.set("f4", &f4)
+		.set("f5", &f5)
+		.set("f6", &f6)
+		.set("f7", &f7)
+		.set("f8", &f8)
+		.set("global", v8pp::property(get_global, set_global))
+		;
+	context.set("m", functions);
+
+	v8pp::class_<point> point_class(isolate);
+	point_class
+		.ctor()
+		.set("x", &point::x)
+		.set("px", v8pp::property(&point::get_x, &point::set_x))
+		.set("sum", &point::sum)
+		.set("move", &point::move)
+		.set_index_interceptor(v8pp::intercept_get(&point::at))
+		;
+	context.set("Point", point_class);
+
+	v8pp::class_<plain_record> record_class(isolate);
+	record_class
+		.ctor()
+		.set_named_interceptor(v8pp::intercept_get_set(&plain_record::field, &plain_record::set_field))
+		;
+	context.set("Record", record_class);
+
+	v8pp::class_<hot_record> hot_record_class(isolate);
+	hot_record_class
+		.ctor()
+		.set_named_interceptor(v8pp::intercept_get_set(&hot_record::field, &hot_record::set_field))
+		.promote_hot_keys(&hot_record::stable_key)
+		;
+	context.set("HotRecord", hot_record_class);
+
+	static char const* const free_calls[] =
+	{
+		"m.f0();",
+		"m.f1(1);",
+		"m.f2(1, 2);",
+		"m.f3(1, 2, 3);",
+		"m.f4(1, 2, 3, 4);",
+		"m.f5(1, 2, 3, 4, 5);",
+		"m.f6(1, 2, 3, 4, 5, 6);",
+		"m.f7(1, 2, 3, 4, 5, 6, 7);",
+		"m.f8(1, 2, 3, 4, 5, 6, 7, 8);",
+	};
+	for (size_t i = 0; i < sizeof(free_calls) / sizeof(*free_calls); ++i)
+	{
+		v8::Local<v8::Function> loop = js_loop(context, free_calls[i]);
+		std::string const name = "free_function_" + std::to_string(i);
+		runner.run("call", name.c_str(), 1000000,
+			[&](uint64_t n) { run_js_loop(context, loop, n); });
+	}
+
+	struct js_case
+	{
+		char const* name;
+		char const* body;
+	};
+	static js_case const cases[] =
+	{
+		{ "member_function_1", "p.sum(i);" },
+		{ "member_function_2", "p.move(1, -1);" },
+		{ "member_data_get", "s += p.x;" },
+		{ "member_data_set", "p.x = i;" },
+		{ "property_get", "s += p.px;" },
+		{ "property_set", "p.px = i;" },
+		{ "module_property_get", "s += m.global;" },
+		{ "module_property_set", "m.global = i;" },
+		{ "index_interceptor_get", "s += p[i & 1];" },
+		{ "named_interceptor_get", "s += r.x + r.y;" },
+		{ "named_interceptor_set", "r.x = i;" },
+		{ "promoted_key_get", "s += h.x + h.y;" },
+		{ "promoted_key_set", "h.x = i;" },
+	};
+	for (js_case const& c : cases)
+	{
+		v8::Local<v8::Function> loop = js_loop(context, c.body,
+			"var p = new Point(); var r = new Record(); var h = new HotRecord(); var s = 0;");
+		runner.run("call", c.name, 1000000,
+			[&](uint64_t n) { run_js_loop(context, loop, n); });
+	}
+}
@@ -0,0 +1,80 @@
+#include "v8pp/call_v8.hpp"
+#include "v8pp/context.hpp"
+
+#include "bench.hpp"
+
+#include <tuple>
+#include <vector>
+
+void bench_call_v8(bench_runner& runner)
+{
+	v8pp::context context;
+	v8::Isolate* isolate = context.isolate();
+	v8::HandleScope scope(isolate);
+
+	v8::Local<v8::Function> f0 = context.run_script("(function() { return 0; })").As<v8::Function>();
+	v8::Local<v8::Function> f1 = context.run_script("(function(a) { return a; })").As<v8::Function>();
+	v8::Local<v8::Function> f3 = context.run_script("(function(a, b, c) { return a + b + c; })").As<v8::Function>();
+	v8::Local<v8::Function> fs = context.run_script("(function(s) { return s.length; })").As<v8::Function>();
+	v8::Local<v8::Value> recv = context.global();
+
+	runner.run("call_v8", "args_0", 1000000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8::HandleScope scope(isolate);
+			do_not_optimize(v8pp::call_v8(isolate, f0, recv));
+		}
+	});
+
+	runner.run("call_v8", "args_1", 1000000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8::HandleScope scope(isolate);
+			do_not_optimize(v8pp::call_v8(isolate, f1, recv, static_cast<int>(i)));
+		}
+	});
+
+	runner.run("call_v8", "args_3", 1000000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8::HandleScope scope(isolate);
+			do_not_optimize(v8pp::call_v8(isolate, f3, recv, 1, 2.5, static_cast<int>(i)));
+		}
+	});
+
+	runner.run("call_v8", "string_arg", 1000000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8::HandleScope scope(isolate);
+			do_not_optimize(v8pp::call_v8(isolate, fs, recv, "string argument"));
+		}
+	});
+
+	v8pp::bound_function<double (int, double, int)> bound_f3(isolate, f3, recv);
+
+	runner.run("call_v8", "bound_args_3", 1000000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			do_not_optimize(bound_f3(1, 2.5, static_cast<int>(i)));
+		}
+	});
+
+	std::vector<std::tuple<int, double, int>> batch_args;
+	for (int i = 0; i < 1000; ++i)
+	{
+		batch_args.emplace_back(1, 2.5, i);
+	}
+
+	runner.run("call_v8", "bound_batch_1000_args_3", 1000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			do_not_optimize(bound_f3.call_batch(batch_args));
+		}
+	});
+}
@@ -0,0 +1,102 @@
+#include "v8pp/binding_set.hpp"
+#include "v8pp/class.hpp"
+#include "v8pp/context.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+template<int N>
+struct bound_class
+{
+	int value = N;
+
+	int get() const { return value; }
+	void set(int v) { value = v; }
+	int add(int x) const { return value + x; }
+	int mul(int x) const { return value * x; }
+};
+
+template<int N, typename Target>
+void bind_class(Target& target)
+{
+	v8pp::class_<bound_class<N>> cl(target.isolate());
+	cl
+		.ctor()
+		.set("value", &bound_class<N>::value)
+		.set("prop", v8pp::property(&bound_class<N>::get, &bound_class<N>::set))
+		.set("add", &bound_class<N>::add)
+		.set("mul", &bound_class<N>::mul)
+		;
+	std::string const name = "class" + std::to_string(N);
+	target.set(name.c_str(), cl);
+}
+
+template<int N>
+struct bind_classes
+{
+	template<typename Target>
+	static void bind(Target& target)
+	{
+		bind_classes<N - 1>::bind(target);
+		bind_class<N - 1>(target);
+	}
+};
+
+template<>
+struct bind_classes<0>
+{
+	template<typename Target>
+	static void bind(Target&) {}
+};
+
+} // unnamed namespace
+
+void bench_context(bench_runner& runner)
+{
+	runner.run("context", "create_destroy", 100, [](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8pp::context context;
+		}
+	});
+
+	runner.run("context", "create_run_destroy", 100, [](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8pp::context context;
+			v8::HandleScope scope(context.isolate());
+			do_not_optimize(context.run_script("1 + 1"));
+		}
+	});
+
+	// classes are materialized on first use, a script uses one of them
+	runner.run("context", "create_64_classes_use_1", 100, [](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8pp::context context;
+			v8::HandleScope scope(context.isolate());
+			bind_classes<64>::bind(context);
+			do_not_optimize(context.run_script("new class7().add(1)"));
+		}
+	});
+
+	// bindings are made once, new contexts on the warm isolate only install them
+	runner.run("context", "new_context_binding_set_64_classes", 1000, [](uint64_t n)
+	{
+		v8pp::context host;
+		v8::HandleScope scope(host.isolate());
+		v8pp::binding_set bindings(host.isolate());
+		bind_classes<64>::bind(bindings);
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8::HandleScope iteration_scope(host.isolate());
+			v8pp::context context(host.isolate());
+			bindings.install(context);
+			do_not_optimize(context.run_script("new class7().add(1)"));
+		}
+	});
+}
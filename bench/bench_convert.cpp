@@ -0,0 +1,114 @@
+#include <map>
+#include <string>
+#include <vector>
+
+#include "v8pp/context.hpp"
+#include "v8pp/convert.hpp"
+
+#include "bench.hpp"
+
+void bench_convert(bench_runner& runner)
+{
+	v8pp::context context;
+	v8::Isolate* isolate = context.isolate();
+	v8::HandleScope scope(isolate);
+
+	std::string const short_str = "short string";
+	std::string const long_str(4096, 'x');
+
+	std::vector<int> vec(100);
+	for (size_t i = 0; i < vec.size(); ++i)
+	{
+		vec[i] = static_cast<int>(i);
+	}
+
+	std::map<std::string, int> map;
+	for (int i = 0; i < 100; ++i)
+	{
+		map["key" + std::to_string(i)] = i;
+	}
+
+	runner.run("convert", "int_to_from_v8", 1000000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8::HandleScope scope(isolate);
+			int const value = v8pp::from_v8<int>(isolate, v8pp::to_v8(isolate, static_cast<int>(i)));
+			do_not_optimize(value);
+		}
+	});
+
+	struct string_case
+	{
+		char const* to_name;
+		char const* from_name;
+		std::string const& str;
+		uint64_t iterations;
+	};
+	string_case const strings[] =
+	{
+		{ "short_string_to_v8", "short_string_from_v8", short_str, 1000000 },
+		{ "long_string_to_v8", "long_string_from_v8", long_str, 100000 },
+	};
+	for (string_case const& c : strings)
+	{
+		runner.run("convert", c.to_name, c.iterations, [&](uint64_t n)
+		{
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				v8::HandleScope scope(isolate);
+				do_not_optimize(v8pp::to_v8(isolate, c.str));
+			}
+		});
+
+		v8::Local<v8::Value> value = v8pp::to_v8(isolate, c.str);
+		runner.run("convert", c.from_name, c.iterations, [&](uint64_t n)
+		{
+			for (uint64_t i = 0; i < n; ++i)
+			{
+				std::string const str = v8pp::from_v8<std::string>(isolate, value);
+				do_not_optimize(str);
+			}
+		});
+	}
+
+	runner.run("convert", "vector_int_to_v8", 100000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8::HandleScope scope(isolate);
+			do_not_optimize(v8pp::to_v8(isolate, vec));
+		}
+	});
+
+	v8::Local<v8::Value> v8_vec = v8pp::to_v8(isolate, vec);
+	runner.run("convert", "vector_int_from_v8", 100000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8::HandleScope scope(isolate);
+			std::vector<int> const result = v8pp::from_v8<std::vector<int>>(isolate, v8_vec);
+			do_not_optimize(result);
+		}
+	});
+
+	runner.run("convert", "map_string_int_to_v8", 10000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8::HandleScope scope(isolate);
+			do_not_optimize(v8pp::to_v8(isolate, map));
+		}
+	});
+
+	v8::Local<v8::Value> v8_map = v8pp::to_v8(isolate, map);
+	runner.run("convert", "map_string_int_from_v8", 10000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8::HandleScope scope(isolate);
+			std::map<std::string, int> const result = v8pp::from_v8<std::map<std::string, int>>(isolate, v8_map);
+			do_not_optimize(result);
+		}
+	});
+}
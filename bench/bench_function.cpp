@@ -0,0 +1,83 @@
+#include "v8pp/any_object.h"
+#include "v8pp/any_object_hidden.h"
+#include "v8pp/call_v8.hpp"
+#include "v8pp/context.hpp"
+
+#include "bench.hpp"
+
+#include <functional>
+
+namespace {
+
+int add(int a, int b) { return a + b; }
+
+} // unnamed namespace
+
+void bench_function(bench_runner& runner)
+{
+	v8pp::context context;
+	v8::Isolate* isolate = context.isolate();
+	v8::HandleScope scope(isolate);
+
+	// C++ callables, std::function is the baseline for v8pp::Function
+	std::function<int (int, int)> std_add = add;
+	v8pp::Function<int (int, int)> v8pp_add = add;
+
+	runner.run("function", "std_function_cpp", 10000000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			do_not_optimize(std_add(1, static_cast<int>(i)));
+		}
+	});
+
+	runner.run("function", "v8pp_function_cpp", 10000000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			do_not_optimize(v8pp_add(1, static_cast<int>(i)));
+		}
+	});
+
+	int const offset = 1;
+	v8pp::Function<int (int)> v8pp_lambda = [offset](int a) { return a + offset; };
+
+	runner.run("function", "v8pp_function_lambda", 10000000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			do_not_optimize(v8pp_lambda(static_cast<int>(i)));
+		}
+	});
+
+	// JavaScript function, call_v8 with from_v8 is the baseline for v8pp::Function
+	v8::Local<v8::Function> js_add = context.run_script("(function(a, b) { return a + b; })").As<v8::Function>();
+	v8::Local<v8::Value> recv = context.global();
+	v8pp::Function<int (int, int)> v8pp_js_add(js_add, isolate);
+
+	runner.run("function", "call_v8_js", 1000000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8::HandleScope scope(isolate);
+			do_not_optimize(v8pp::from_v8<int>(isolate, v8pp::call_v8(isolate, js_add, recv, 1, static_cast<int>(i))));
+		}
+	});
+
+	runner.run("function", "v8pp_function_js", 1000000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			do_not_optimize(v8pp_js_add(1, static_cast<int>(i)));
+		}
+	});
+
+	runner.run("function", "copy_v8pp_function_cpp", 1000000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8pp::Function<int (int, int)> copy = v8pp_add;
+			do_not_optimize(copy);
+		}
+	});
+}
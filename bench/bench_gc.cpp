@@ -0,0 +1,99 @@
+#include "v8pp/class.hpp"
+#include "v8pp/context.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+struct collected
+{
+	static uint64_t destroyed;
+	~collected() { ++destroyed; }
+};
+
+uint64_t collected::destroyed = 0;
+
+struct collected_batched
+{
+	static uint64_t destroyed;
+	~collected_batched() { ++destroyed; }
+};
+
+uint64_t collected_batched::destroyed = 0;
+
+struct point
+{
+	float x, y, z;
+};
+
+} // unnamed namespace
+
+void bench_gc(bench_runner& runner)
+{
+	v8pp::context context;
+	v8::Isolate* isolate = context.isolate();
+	v8::HandleScope scope(isolate);
+
+	v8pp::class_<collected> collected_class(isolate);
+	collected_class.ctor();
+	context.set("Collected", collected_class);
+
+	// objects are created in JavaScript and collected by a full GC,
+	// compare with wrap.js_new_object for the creation cost
+	v8::Local<v8::Function> create = js_loop(context, "new Collected();");
+	runner.run("gc", "create_and_collect", 100000, [&](uint64_t n)
+	{
+		uint64_t const destroyed = collected::destroyed;
+		run_js_loop(context, create, n);
+		isolate->RequestGarbageCollectionForTesting(v8::Isolate::kFullGarbageCollection);
+		if (collected::destroyed - destroyed < n / 2)
+		{
+			throw std::runtime_error("weak callbacks were not invoked");
+		}
+	});
+
+	v8pp::class_<collected_batched> batched_class(isolate);
+	batched_class
+		.ctor()
+		.set_destroy_policy(v8pp::destroy_batched)
+		;
+	context.set("CollectedBatched", batched_class);
+
+	// weak callbacks only queue objects, destroyed together after the GC
+	v8::Local<v8::Function> create_batched = js_loop(context, "new CollectedBatched();");
+	runner.run("gc", "create_and_collect_batched", 100000, [&](uint64_t n)
+	{
+		uint64_t const destroyed = collected_batched::destroyed;
+		run_js_loop(context, create_batched, n);
+		isolate->RequestGarbageCollectionForTesting(v8::Isolate::kFullGarbageCollection);
+		if (collected_batched::destroyed - destroyed < n / 2)
+		{
+			throw std::runtime_error("weak callbacks were not invoked");
+		}
+	});
+
+	v8pp::class_<point> point_class(isolate);
+	point_class
+		.set_inline_values()
+		.ctor()
+		;
+	context.set("Point", point_class);
+
+	// values in wrapper slabs, no C++ allocation and weak callback
+	v8::Local<v8::Function> create_inline = js_loop(context, "new Point();");
+	runner.run("gc", "create_and_collect_inline", 100000, [&](uint64_t n)
+	{
+		run_js_loop(context, create_inline, n);
+		isolate->RequestGarbageCollectionForTesting(v8::Isolate::kFullGarbageCollection);
+	});
+
+	runner.run("gc", "imported_objects_destroy", 100000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8::HandleScope scope(isolate);
+			v8pp::class_<collected>::import_external(isolate, new collected);
+		}
+		isolate->RequestGarbageCollectionForTesting(v8::Isolate::kFullGarbageCollection);
+	});
+}
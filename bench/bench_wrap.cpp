@@ -0,0 +1,68 @@
+#include <vector>
+
+#include "v8pp/class.hpp"
+#include "v8pp/context.hpp"
+
+#include "bench.hpp"
+
+namespace {
+
+struct wrapped
+{
+	int value = 0;
+	int get() const { return value; }
+};
+
+} // unnamed namespace
+
+void bench_wrap(bench_runner& runner)
+{
+	v8pp::context context;
+	v8::Isolate* isolate = context.isolate();
+	v8::HandleScope scope(isolate);
+
+	v8pp::class_<wrapped> wrapped_class(isolate);
+	wrapped_class
+		.ctor()
+		.set("get", &wrapped::get)
+		;
+	context.set("Wrapped", wrapped_class);
+
+	std::vector<wrapped> objects(10000);
+
+	runner.run("wrap", "reference_external", objects.size(), [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8::HandleScope scope(isolate);
+			wrapped* obj = &objects[i % objects.size()];
+			do_not_optimize(v8pp::class_<wrapped>::reference_external(isolate, obj));
+			v8pp::class_<wrapped>::remove_object(isolate, obj);
+		}
+	});
+
+	v8::Local<v8::Object> js_obj = v8pp::class_<wrapped>::reference_external(isolate, &objects[0]);
+	runner.run("wrap", "unwrap_object", 1000000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			do_not_optimize(v8pp::class_<wrapped>::unwrap_object(isolate, js_obj));
+		}
+	});
+
+	runner.run("wrap", "find_object", 1000000, [&](uint64_t n)
+	{
+		for (uint64_t i = 0; i < n; ++i)
+		{
+			v8::HandleScope scope(isolate);
+			do_not_optimize(v8pp::class_<wrapped>::find_object(isolate, &objects[0]));
+		}
+	});
+	v8pp::class_<wrapped>::remove_object(isolate, &objects[0]);
+
+	v8::Local<v8::Function> loop = js_loop(context, "new Wrapped();");
+	runner.run("wrap", "js_new_object", 100000, [&](uint64_t n)
+	{
+		run_js_loop(context, loop, n);
+	});
+}
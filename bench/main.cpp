@@ -0,0 +1,150 @@
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "v8.h"
+#include "libplatform/libplatform.h"
+
+#include "bench.hpp"
+
+void bench_runner::report(result const& res) const
+{
+	if (!os_)
+	{
+		return;
+	}
+
+	std::vector<double> sorted = res.samples;
+	std::sort(sorted.begin(), sorted.end());
+
+	*os_ << "{\"group\":\"" << res.group << "\""
+		<< ",\"name\":\"" << res.name << "\""
+		<< ",\"iterations\":" << res.iterations
+		<< ",\"repeats\":" << sorted.size()
+		<< ",\"min_ns\":" << sorted.front()
+		<< ",\"median_ns\":" << sorted[sorted.size() / 2]
+		<< ",\"max_ns\":" << sorted.back()
+		<< "}" << std::endl;
+}
+
+v8::Local<v8::Function> js_loop(v8pp::context& context, char const* body, char const* setup)
+{
+	v8::Isolate* isolate = context.isolate();
+	v8::EscapableHandleScope scope(isolate);
+
+	std::string const source = std::string("(function(n) { ") + setup
+		+ "\nfor (var i = 0; i < n; ++i) { " + body + " } })";
+	v8::Local<v8::Value> fn = context.run_script(source, "bench");
+	if (fn.IsEmpty() || !fn->IsFunction())
+	{
+		throw std::runtime_error(std::string("invalid benchmark loop: ") + body);
+	}
+	return scope.Escape(fn.As<v8::Function>());
+}
+
+void run_js_loop(v8pp::context& context, v8::Local<v8::Function> loop, uint64_t n)
+{
+	v8::Isolate* isolate = context.isolate();
+	v8::HandleScope scope(isolate);
+
+	v8::Local<v8::Value> arg = v8pp::to_v8(isolate, static_cast<double>(n));
+	v8::Local<v8::Context> ctx = context.get_context();
+	v8::Local<v8::Value> result;
+	if (!loop->Call(ctx, ctx->Global(), 1, &arg).ToLocal(&result))
+	{
+		throw std::runtime_error("benchmark loop failed");
+	}
+}
+
+int main(int argc, char const * argv[])
+{
+	bench_runner runner;
+	std::string output;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		std::string const arg = argv[i];
+		if (arg == "-h" || arg == "--help")
+		{
+			std::cout << "Usage: " << argv[0] << " [arguments]\n"
+				<< "Arguments:\n"
+				<< "  --help,-h           Print this message and exit\n"
+				<< "  --filter <text>     Run benchmarks with group.name starting with <text>\n"
+				<< "  --repeats <n>       Measure each benchmark <n> times, default 7\n"
+				<< "  --scale <x>         Multiply iteration counts by <x>\n"
+				<< "  --output <file>     Write JSON lines to <file> instead of stdout\n"
+				;
+			return EXIT_SUCCESS;
+		}
+		else if (arg == "--filter" && i + 1 < argc)
+		{
+			runner.set_filter(argv[++i]);
+		}
+		else if (arg == "--repeats" && i + 1 < argc)
+		{
+			runner.set_repeats(std::strtoul(argv[++i], nullptr, 10));
+		}
+		else if (arg == "--scale" && i + 1 < argc)
+		{
+			runner.set_scale(std::strtod(argv[++i], nullptr));
+		}
+		else if (arg == "--output" && i + 1 < argc)
+		{
+			output = argv[++i];
+		}
+		else
+		{
+			std::cerr << "unknown argument " << arg << std::endl;
+			return EXIT_FAILURE;
+		}
+	}
+
+	std::ofstream file;
+	if (!output.empty())
+	{
+		file.open(output.c_str());
+		if (!file)
+		{
+			std::cerr << "could not open " << output << std::endl;
+			return EXIT_FAILURE;
+		}
+		runner.set_output(&file);
+	}
+	else
+	{
+		runner.set_output(&std::cout);
+	}
+
+	// GC benchmarks force collections
+	std::string const v8_flags = "--expose_gc";
+	v8::V8::SetFlagsFromString(v8_flags.data(), (int)v8_flags.length());
+
+	std::unique_ptr<v8::Platform> platform(v8::platform::CreateDefaultPlatform());
+	v8::V8::InitializePlatform(platform.get());
+	v8::V8::InitializeICU();
+	v8::V8::Initialize();
+
+	int result = EXIT_SUCCESS;
+	try
+	{
+		bench_call(runner);
+		bench_convert(runner);
+		bench_call_v8(runner);
+		bench_function(runner);
+		bench_wrap(runner);
+		bench_gc(runner);
+		bench_context(runner);
+	}
+	catch (std::exception const& ex)
+	{
+		std::cerr << ex.what() << std::endl;
+		result = EXIT_FAILURE;
+	}
+
+	v8::V8::Dispose();
+	v8::V8::ShutdownPlatform();
+
+	return result;
+}
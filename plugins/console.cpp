@@ -1,6 +1,7 @@
 #include <iostream>
 #include <v8pp/module.hpp>
 #include <v8pp/config.hpp>
+#include <v8pp/plugin_descriptor.hpp>
 
 namespace console {
 
@@ -24,8 +25,15 @@ v8::Handle<v8::Value> init(v8::Isolate* isolate)
 	return m.new_instance();
 }
 
+v8pp::plugin_export const exports[] =
+{
+	{ "log", &log, 0 },
+};
+
 } // namespace console
 
+V8PP_PLUGIN_DESCRIPTOR("console", console::exports)
+
 V8PP_PLUGIN_INIT(v8::Isolate* isolate)
 {
 	return console::init(isolate);
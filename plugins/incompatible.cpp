@@ -0,0 +1,28 @@
+#include <v8pp/config.hpp>
+#include <v8pp/plugin_descriptor.hpp>
+
+// Test plugin with a descriptor of the next plugin ABI version,
+// the plugin manager should reject it on load
+
+namespace incompatible {
+
+void noop(v8::FunctionCallbackInfo<v8::Value> const&)
+{
+}
+
+v8pp::plugin_export const exports[] =
+{
+	{ "noop", &noop, 0 },
+};
+
+} // namespace incompatible
+
+extern "C" V8PP_EXPORT v8pp::plugin_descriptor const* V8PP_PLUGIN_DESCRIPTOR_PROC_NAME()
+{
+	static v8pp::plugin_descriptor const descriptor =
+	{
+		V8PP_PLUGIN_ABI_VERSION + 1, V8_MAJOR_VERSION, V8_MINOR_VERSION, v8pp::plugin_export_table,
+		"incompatible", incompatible::exports, 1
+	};
+	return &descriptor;
+}
@@ -13,6 +13,7 @@
 void run_tests()
 {
 	void test_functional();
+	void test_persistent_value();
 	void test_utility();
 	void test_context();
 	void test_convert();
@@ -26,10 +27,15 @@ void run_tests()
 	void test_property();
 	void test_object();
 	void test_json();
+	void test_event_loop();
+	void test_profiler();
+	void test_plugin_manager();
+	void test_table();
 
 	std::pair<char const*, void(*)()> tests[] =
 	{
 		{ "test_functional", test_functional },
+		{ "test_persistent_value", test_persistent_value },
 		{ "test_utility", test_utility },
 		{ "test_context", test_context },
 		{ "test_convert", test_convert },
@@ -43,6 +49,10 @@ void run_tests()
 		{ "test_property", test_property },
 		{ "test_object", test_object },
 		{ "test_json", test_json },
+		{ "test_event_loop", test_event_loop },
+		{ "test_profiler", test_profiler },
+		{ "test_plugin_manager", test_plugin_manager },
+		{ "test_table", test_table },
 	};
 
 	for (auto const& test : tests)
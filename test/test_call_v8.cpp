@@ -1,6 +1,9 @@
 #include "v8pp/call_v8.hpp"
 #include "v8pp/context.hpp"
 
+#include <tuple>
+#include <vector>
+
 #include "test.hpp"
 
 static void v8_arg_count(v8::FunctionCallbackInfo<v8::Value> const& args)
@@ -20,4 +23,20 @@ void test_call_v8()
 	check_eq("1 arg", v8pp::call_v8(isolate, fun, fun, 1)->Int32Value(), 1);
 	check_eq("2 args", v8pp::call_v8(isolate, fun, fun, true, 2.2)->Int32Value(), 2);
 	check_eq("3 args", v8pp::call_v8(isolate, fun, fun, 1, true, "abc")->Int32Value(), 3);
+
+	v8::Handle<v8::Function> add = context.run_script("(function(a, b) { return a + b; })").As<v8::Function>();
+	v8pp::bound_function<int (int, int)> bound_add(isolate, add);
+	check_eq("bound call", bound_add(1, 2), 3);
+
+	std::vector<std::tuple<int, int>> const args = { std::make_tuple(1, 2), std::make_tuple(3, 4), std::make_tuple(5, 6) };
+	std::vector<int> results;
+	check_eq("batch count", bound_add.call_batch(args, std::back_inserter(results)), 3u);
+	check_eq("batch results", results, std::vector<int>{ 3, 7, 11 });
+
+	v8::Handle<v8::Function> thrower = context.run_script("(function(a) { if (a > 1) throw a; })").As<v8::Function>();
+	v8pp::bound_function<void (int)> bound_thrower(isolate, thrower);
+	std::vector<std::tuple<int>> const thrower_args = { std::make_tuple(0), std::make_tuple(1), std::make_tuple(2), std::make_tuple(3) };
+	v8::TryCatch try_catch;
+	check_eq("batch stops on exception", bound_thrower.call_batch(thrower_args), 2u);
+	check("exception pending", try_catch.HasCaught());
 }
@@ -24,6 +24,84 @@ struct Y : X
 
 int Y::instance_count = 0;
 
+struct W
+{
+	static int instance_count;
+
+	W() { ++instance_count; }
+	~W() { --instance_count; }
+};
+
+int W::instance_count = 0;
+
+namespace v8pp {
+template<>
+struct thread_safe_destructible<W> : std::true_type
+{
+};
+} // namespace v8pp
+
+struct Z
+{
+	int twice(int x) const { return x * 2; }
+};
+
+struct color
+{
+	int r = 0;
+
+	color brighter() const { color result(*this); result.r += 10; return result; }
+};
+
+struct vec2
+{
+	float x, y;
+
+	vec2(float x, float y) : x(x), y(y) {}
+
+	float length2() const { return x * x + y * y; }
+	vec2 scaled(float k) const { return vec2(x * k, y * k); }
+};
+
+struct record
+{
+	int field(v8pp::string_view name) { return name == "answer" ? 42 : static_cast<int>(name.size()); }
+	bool has_field(v8pp::string_view name) { return name == "answer" || name == "question"; }
+	void fields(v8pp::enum_sink& keys) { keys.reserve(3); keys.add("answer"); keys.add(std::string("question")); }
+};
+
+struct settings
+{
+	int reads = 0;
+	int hot = 1;
+	int warm = 2;
+
+	int get(v8pp::string_view name) { ++reads; return name == "hot" ? hot : name == "warm" ? warm : -1; }
+	void set(v8pp::string_view name, int value) { if (name == "hot") hot = value; else if (name == "warm") warm = value; }
+
+	static bool stable_key(v8pp::string_view name) { return name == "hot" || name == "warm"; }
+};
+
+struct constants
+{
+	int get(v8pp::string_view name) { return name == "hot" ? 1 : -1; }
+};
+
+struct column
+{
+	static int instance_count;
+
+	std::vector<int> values = { 1, 2, 3 };
+
+	column() { ++instance_count; }
+	~column() { --instance_count; }
+
+	int* data() { return values.data(); }
+	size_t size() const { return values.size(); }
+};
+
+int column::instance_count = 0;
+
 namespace v8pp {
 template<>
 struct factory<Y>
@@ -68,6 +146,133 @@ void test_class()
 	check_eq("X::static_fun(1)", run_script<int>(context, "X.static_fun(3)"), 3);
 
 	check_eq("Y object", run_script<int>(context, "y = new Y(-100); y.konst + y.var"), -1);
+	check_eq("Y::fun(1) derived receiver", run_script<int>(context, "y = new Y(-100); y.fun(1)"), -99);
+	check_eq("X::fun wrapper in prototype", run_script<int>(context, "o = Object.create(x); o.fun(1)"), 2);
+
+	using v8pp::detail::wrapper_header;
+	void const* header = wrapper_header::get(context.run_script("new X()").As<v8::Object>());
+	check("X wrapper header", header != nullptr);
+	check_eq("X wrapper header flags", wrapper_header::flags(header), 0u);
+	check("plain object header", wrapper_header::get(v8::Object::New(isolate)) == nullptr);
+
+	v8pp::class_<Z> Z_class(isolate);
+	Z_class
+		.ctor()
+		.set("twice", &Z::twice)
+		.set_receiver_check(true)
+		;
+	context.set("Z", Z_class);
+
+	v8pp::detail::class_singleton<Z>& Z_singleton = v8pp::detail::class_singleton<Z>::instance(isolate);
+	check("Z not materialized", !Z_singleton.materialized());
+	check_eq("Z pending bindings", Z_singleton.pending_bindings(), 2u); // twice and class name
+	check_eq("Z::twice", run_script<int>(context, "new Z().twice(21)"), 42);
+	check_eq("Z::twice signature", run_script<int>(context,
+		"try { new Z().twice.call({}, 1); 0 } catch (e) { e instanceof TypeError ? 1 : 2 }"), 1);
+	check("Z materialized", Z_singleton.materialized());
+	v8pp::class_<color> color_class(isolate);
+	color_class
+		.ctor()
+		.set("r", &color::r)
+		.set("brighter", &color::brighter)
+		;
+	context.set("color", color_class);
+	check_eq("color returned by value", run_script<int>(context,
+		"c = new color(); c.r = 5; d = c.brighter(); d instanceof color && d !== c ? d.r : -1"), 15);
+
+	v8pp::class_<vec2> vec2_class(isolate);
+	vec2_class
+		.set_inline_values(16)
+		.ctor<float, float>()
+		.set("x", &vec2::x)
+		.set("length2", &vec2::length2)
+		.set("scaled", &vec2::scaled)
+		;
+	context.set("vec2", vec2_class);
+	check_eq("vec2 inline value", run_script<float>(context, "v = new vec2(3, 4); v.x = 6; v.length2()"), 52.0f);
+	check_eq("vec2 inline values in slabs", run_script<double>(context,
+		"s = 0; for (i = 0; i < 100; ++i) { s += new vec2(i, 1).scaled(2).length2(); } s"), 1313800.0);
+	void const* vec2_header = wrapper_header::get(context.run_script("new vec2(1, 2)").As<v8::Object>());
+	check_eq("vec2 wrapper header flags", wrapper_header::flags(vec2_header), unsigned(wrapper_header::inline_value));
+	std::vector<vec2*> vec2_objects;
+	v8pp::detail::class_singleton<vec2>::instance(isolate).all_objects(vec2_objects);
+	check("vec2 values are not tracked", vec2_objects.empty());
+
+	check_eq("Z replaced by data property", run_script<bool>(context, "Object.getOwnPropertyDescriptor(this, 'Z').value === Z"), true);
+
+	v8pp::class_<record> record_class(isolate);
+	record_class
+		.ctor()
+		.set_named_interceptor(v8pp::intercept_get_enum_query(&record::field, &record::fields, &record::has_field))
+		;
+	context.set("record", record_class);
+	check_eq("string_view key", run_script<int>(context, "r = new record(); r.answer"), 42);
+	check_eq("long string_view key", run_script<int>(context, "r[new Array(201).join('k')]"), 200);
+	check_eq("string_view query", run_script<bool>(context, "'answer' in r && !('other' in r)"), true);
+	check_eq("enum_sink keys", run_script<std::string>(context, "Object.keys(r).join()"), "answer,question");
+
+	v8pp::class_<settings> settings_class(isolate);
+	settings_class
+		.ctor()
+		.set_named_interceptor(v8pp::intercept_get_set(&settings::get, &settings::set))
+		.promote_hot_keys(&settings::stable_key, 2)
+		;
+	context.set("settings", settings_class);
+	run_script<int>(context, "s = new settings(); for (i = 0; i < 10; ++i) s.hot + s.cold; i");
+	settings* s = v8pp::class_<settings>::unwrap_object(isolate, context.run_script("s"));
+	check_eq("promoted key reads", s->reads, 20); // promoted accessor calls the getter
+	check_eq("promoted key accessor", run_script<bool>(context, "Object.getOwnPropertyDescriptor(s, 'hot') !== undefined"), true);
+	check_eq("unstable key not promoted", run_script<bool>(context, "Object.getOwnPropertyDescriptor(s, 'cold') === undefined"), true);
+	check_eq("promoted key setter", run_script<int>(context, "s.hot = 5; s.hot"), 5);
+	check_eq("promoted key value", s->hot, 5);
+	run_script<int>(context, "for (i = 0; i < 10; ++i) s.warm; i");
+	check_eq("second promoted key", run_script<int>(context,
+		"Object.getOwnPropertyDescriptor(s, 'warm') !== undefined ? (s.warm = 7, s.warm) : -1"), 7);
+	check_eq("second promoted key value", s->warm, 7);
+	// many keys with possible identity hash collisions stay unpromoted
+	check_eq("unstable keys not promoted", run_script<int>(context,
+		"n = 0; for (j = 0; j < 5000; ++j) { k = 'k' + j; s[k]; s[k]; s[k];"
+		" if (Object.getOwnPropertyDescriptor(s, k) !== undefined) ++n; } n"), 0);
+	check("cold keys are not kept", v8pp::detail::class_singleton<settings>::instance(isolate).counted_keys() <= 256 + 2);
+	check_eq("promoted keys kept", run_script<int>(context, "s.hot + s.warm"), 12);
+	v8pp::class_<settings>::demote_keys(isolate, s);
+	check_eq("demoted key", run_script<bool>(context, "Object.getOwnPropertyDescriptor(s, 'hot') === undefined && s.hot == 5"), true);
+	v8pp::class_<settings>::reset_promoted_keys(isolate);
+	run_script<int>(context, "s.hot");
+	check_eq("reset promoted keys", run_script<bool>(context, "Object.getOwnPropertyDescriptor(s, 'hot') === undefined"), true);
+
+	v8pp::class_<constants> constants_class(isolate);
+	constants_class
+		.ctor()
+		.set_named_interceptor(v8pp::intercept_get(&constants::get))
+		.promote_hot_keys(&settings::stable_key, 2)
+		;
+	context.set("constants", constants_class);
+	check_eq("read-only interceptor key not promoted", run_script<bool>(context,
+		"c = new constants(); for (i = 0; i < 10; ++i) c.hot; Object.getOwnPropertyDescriptor(c, 'hot') === undefined"), true);
+	check_eq("read-only interceptor key assignment", run_script<int>(context, "c.hot = 5; c.hot"), 5);
+
+	v8pp::class_<column> column_class(isolate);
+	column_class
+		.ctor()
+		.set_indexed_storage(&column::data, &column::size)
+		.set_typed_array("view", &column::data, &column::size)
+		;
+	context.set("column", column_class);
+	check_eq("indexed storage", run_script<int>(context, "c = new column(); c[0] + c[1] + c[2]"), 6);
+	check_eq("indexed storage bounds", run_script<bool>(context, "c[3] === undefined && Object.keys(c).length == 3"), true);
+	check_eq("indexed storage set", run_script<int>(context, "c[1] = 20; c[1]"), 20);
+	check_eq("typed array view", run_script<int>(context, "c.view instanceof Int32Array && c.view[1]"), 20);
+	check_eq("typed array view set", run_script<int>(context, "c.view[2] = 30; c[2]"), 30);
+	check_eq("typed array view cached", run_script<bool>(context, "c.view === c.view"), true);
+	run_script<int>(context, "v = new column().view; 0");
+	context.isolate()->RequestGarbageCollectionForTesting(v8::Isolate::GarbageCollectionType::kFullGarbageCollection);
+	check_eq("typed array view keeps object", column::instance_count, 2);
+	check_eq("typed array view after GC", run_script<int>(context, "v[0] = 5; v[0] + v[1]"), 7);
+	run_script<int>(context, "v = null; 0");
+	context.isolate()->RequestGarbageCollectionForTesting(v8::Isolate::GarbageCollectionType::kFullGarbageCollection);
+	check_eq("typed array view released object", column::instance_count, 1);
+
 	v8pp::class_<Y>::reference_external(context.isolate(), new Y(-1));
 	
 	run_script<int>(context, "for (i = 0; i < 10; ++i) new Y(i); i");
@@ -82,4 +287,59 @@ void test_class()
 	context.isolate()->RequestGarbageCollectionForTesting(v8::Isolate::GarbageCollectionType::kFullGarbageCollection);
 
 	check_eq("Y count after GC", Y::instance_count, 1); // 1 reference_external
+
+	v8pp::class_<W> W_class(isolate);
+	W_class
+		.ctor()
+		.set_destroy_policy(v8pp::destroy_batched)
+		;
+	context.set("W", W_class);
+	run_script<int>(context, "for (i = 0; i < 10; ++i) new W(); i");
+	check_eq("W count", W::instance_count, 10);
+	context.isolate()->RequestGarbageCollectionForTesting(v8::Isolate::GarbageCollectionType::kFullGarbageCollection);
+	check_eq("W batched destroy after GC", W::instance_count, 0);
+	check_eq("W no pending objects", v8pp::detail::class_singleton<W>::instance(isolate).pending_objects(), 0u);
+
+	W_class.set_destroy_policy(v8pp::destroy_background);
+	run_script<int>(context, "for (i = 0; i < 10; ++i) new W(); i");
+	context.isolate()->RequestGarbageCollectionForTesting(v8::Isolate::GarbageCollectionType::kFullGarbageCollection);
+	v8pp::background_deleter::instance().flush();
+	check_eq("W background destroy after GC", W::instance_count, 0);
+
+	W_class.set_destroy_policy(v8pp::destroy_idle);
+	run_script<int>(context, "for (i = 0; i < 10; ++i) new W(); i");
+	context.isolate()->RequestGarbageCollectionForTesting(v8::Isolate::GarbageCollectionType::kFullGarbageCollection);
+	check_eq("W idle destroy deferred after GC", W::instance_count, 10);
+	context.idle_notification(std::chrono::milliseconds(100));
+	check_eq("W idle destroy", W::instance_count, 0);
+
+	W_class.set_destroy_policy(v8pp::destroy_idle, 0);
+	run_script<int>(context, "for (i = 0; i < 10; ++i) new W(); i");
+	context.isolate()->RequestGarbageCollectionForTesting(v8::Isolate::GarbageCollectionType::kFullGarbageCollection);
+	check_eq("W idle destroy over pending memory limit", W::instance_count, 0);
+
+	// factory<Y> specialization has no object_size
+	int const Y_count = Y::instance_count;
+	Y_class.set_destroy_policy(v8pp::destroy_batched);
+	run_script<int>(context, "for (i = 0; i < 10; ++i) new Y(i); i");
+	check_eq("Y custom factory count", Y::instance_count, Y_count + 10);
+	context.isolate()->RequestGarbageCollectionForTesting(v8::Isolate::GarbageCollectionType::kFullGarbageCollection);
+	check_eq("Y custom factory batched destroy after GC", Y::instance_count, Y_count);
+
+	Y_class.set_destroy_policy(v8pp::destroy_idle, 0);
+	run_script<int>(context, "for (i = 0; i < 10; ++i) new Y(i); i");
+	context.isolate()->RequestGarbageCollectionForTesting(v8::Isolate::GarbageCollectionType::kFullGarbageCollection);
+	check_eq("Y custom factory idle destroy over pending memory limit", Y::instance_count, Y_count);
+
+	struct U {};
+	bool background_unsafe = false;
+	try
+	{
+		v8pp::class_<U>(isolate).set_destroy_policy(v8pp::destroy_background);
+	}
+	catch (std::runtime_error const&)
+	{
+		background_unsafe = true;
+	}
+	check("destroy_background requires thread_safe_destructible", background_unsafe);
 }
@@ -1,12 +1,130 @@
+#include "v8pp/binding_set.hpp"
+#include "v8pp/class.hpp"
 #include "v8pp/context.hpp"
+#include "v8pp/module.hpp"
 
 #include "test.hpp"
 
+#include <memory>
+
+namespace {
+
+int twice(int x) { return x * 2; }
+
+struct counter
+{
+	int value = 0;
+	int next() { return ++value; }
+};
+
+} // unnamed namespace
+
 void test_context()
 {
-	v8pp::context context;
+	{
+		v8pp::context context;
+
+		v8::HandleScope scope(context.isolate());
+		int const r = context.run_script("42")->Int32Value();
+		check_eq("run_script", r, 42);
+
+		context.run_script("for (;;) {}", v8pp::execution_limit(std::chrono::milliseconds(50)), "", false);
+		check("wall time termination", context.last_termination() == v8pp::termination_reason::timeout);
+
+		context.set_execution_limit(v8pp::execution_limit(std::chrono::milliseconds(0), std::chrono::milliseconds(50)));
+		context.run_script("for (;;) {}", "", false);
+		check("cpu time termination", context.last_termination() == v8pp::termination_reason::timeout);
+
+		check_eq("usable after termination", context.run_script("40 + 2")->Int32Value(), 42);
+		check("completed", context.last_termination() == v8pp::termination_reason::none);
+
+		context.run_script("throw 1", "", false);
+		check("exception", context.last_termination() == v8pp::termination_reason::exception);
+	}
+
+	{
+		v8pp::isolate_params params;
+		params.max_old_space_size = 32;
+		v8pp::context context(nullptr, v8pp::context_callback(), v8pp::global_object_callback(), true, params);
+
+		v8::HandleScope scope(context.isolate());
+		context.run_script("var a = []; for (;;) a.push({ x: a.length });", "", false);
+		check("heap limit termination", context.last_termination() == v8pp::termination_reason::out_of_memory);
+		check("heap exhausted", context.heap_exhausted());
+		check("heap size limit", context.heap_stats().heap_size_limit != 0);
+	}
+
+	{
+		v8pp::pooled_allocator allocator;
+		void* block = allocator.Allocate(5000);
+		allocator.Free(block, 5000);
+		check("pooled block reused", allocator.AllocateUninitialized(6000) == block);
+		allocator.Free(block, 6000);
+		check_eq("cached bytes", allocator.cached_bytes(), 8192u);
+
+		v8pp::isolate_params params;
+		params.allocator = &allocator;
+		v8pp::context context(nullptr, v8pp::context_callback(), v8pp::global_object_callback(), true, params);
+		check("context allocator", context.allocator() == &allocator);
+
+		v8::HandleScope scope(context.isolate());
+		context.run_script("var buffers = []; for (var i = 0; i < 10; ++i) buffers.push(new ArrayBuffer(4096));");
+		v8pp::array_buffer_allocator::statistics const stats = allocator.stats();
+		check("allocations", stats.allocations >= 12);
+		check("allocated bytes", stats.allocated_bytes >= 10 * 4096);
+	}
+
+	{
+		// detached isolate keeps the context allocator
+		v8::Isolate* isolate;
+		std::unique_ptr<v8pp::array_buffer_allocator> allocator;
+		{
+			v8pp::context context;
+			isolate = context.detach_isolate();
+			allocator.reset(context.allocator());
+		}
+		{
+			v8pp::context other(isolate);
+			v8::HandleScope scope(isolate);
+			check_eq("detached isolate allocation", run_script<int>(other, "new ArrayBuffer(64).byteLength"), 64);
+			check("detached isolate allocator", allocator->stats().allocations > 0);
+		}
+		isolate->Exit();
+		isolate->Dispose();
+	}
+
+	{
+		v8pp::context context;
+		v8::Isolate* isolate = context.isolate();
+		v8::HandleScope scope(isolate);
+
+		v8pp::class_<counter> counter_class(isolate);
+		counter_class
+			.ctor()
+			.set("next", &counter::next)
+			;
+
+		v8pp::module consts(isolate);
+		consts.set_const("answer", 42);
+
+		v8pp::binding_set bindings(isolate);
+		bindings
+			.set("twice", &twice)
+			.set("consts", consts)
+			.set("counter", counter_class)
+			;
+		check_eq("binding set size", bindings.size(), 3u);
+
+		bindings.install(context);
+		check_eq("installed function", run_script<int>(context, "twice(21)"), 42);
+		check_eq("installed module", run_script<int>(context, "consts.answer"), 42);
 
-	v8::HandleScope scope(context.isolate());
-	int const r = context.run_script("42")->Int32Value();
-	check_eq("run_script", r, 42);
+		v8pp::context other(isolate);
+		bindings.install(other);
+		check_eq("other context class", run_script<int>(other, "var c = new counter(); c.next(); c.next()"), 2);
+		check_eq("other context function", run_script<int>(other, "twice(5)"), 10);
+		check("own module instance", run_script<bool>(other, "consts.x = 1; consts.x === 1"));
+		check("module instance not shared", run_script<bool>(context, "consts.x === undefined"));
+		check("own class function", run_script<bool>(context, "typeof counter === 'function'"));
+	}
 }
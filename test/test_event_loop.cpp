@@ -0,0 +1,38 @@
+#include "v8pp/context.hpp"
+#include "v8pp/event_loop.hpp"
+
+#include "test.hpp"
+
+#include <vector>
+
+void test_event_loop()
+{
+	v8pp::context context;
+	v8::HandleScope scope(context.isolate());
+
+	std::vector<int> order;
+	v8pp::event_loop& loop = context.loop();
+	loop.set_timer([&order]() { order.push_back(3); }, std::chrono::milliseconds(5));
+	loop.set_timer([&order]() { order.push_back(2); }, std::chrono::milliseconds(0));
+	loop.post([&order]() { order.push_back(1); });
+	v8pp::event_loop::timer_id const cleared = loop.set_timer([&order]() { order.push_back(4); },
+		std::chrono::milliseconds(1));
+	check("clear_timer", loop.clear_timer(cleared));
+	context.run_until_idle();
+	check_eq("tasks order", order, std::vector<int>{ 1, 2, 3 });
+	check("loop is empty", loop.empty());
+
+	context.run_script(
+		"var ticks = 0;"
+		"var id = setInterval(function() { if (++ticks == 3) clearInterval(id); }, 1);"
+		"setTimeout(function(a, b) { ticks += a + b; }, 2, 40, 60);");
+	context.run_until_idle();
+	check_eq("timers", context.run_script("ticks")->Int32Value(), 103);
+
+	context.run_script(
+		"var fired = 0;"
+		"var long_ids = [setTimeout(function() { ++fired; }, Infinity), setTimeout(function() { ++fired; }, 1e30)];"
+		"setTimeout(function() { long_ids.forEach(clearTimeout); }, 1);");
+	context.run_until_idle();
+	check_eq("long delays clamped", context.run_script("fired")->Int32Value(), 0);
+}
@@ -52,4 +52,22 @@ void test_module()
 	check_eq("module.rprop", run_script<int>(context, "module.rprop"), 2);
 	check_eq("module.wrop", run_script<int>(context, "++module.wprop"), 3);
 	check_eq("x", x, 2);
+
+	v8pp::module lazy(context.isolate(), true);
+	v8pp::module lazy_sub(context.isolate(), true);
+	lazy_sub.set("fun", &fun);
+	lazy
+		.set("sub", lazy_sub)
+		.set("fun", &fun)
+		.set("rprop", v8pp::property(get_x))
+		;
+	check("lazy module", lazy.lazy());
+	context.set("lazy", lazy);
+
+	check_eq("lazy.fun", run_script<int>(context, "lazy.fun(1)"), 2);
+	check_eq("lazy.fun.name", run_script<std::string>(context, "lazy.fun.name"), "fun");
+	check_eq("lazy.sub.fun", run_script<int>(context, "lazy.sub.fun(2)"), 3);
+	check("lazy.sub replaced", run_script<bool>(context, "lazy.sub === lazy.sub"));
+	check("lazy.fun assigned", run_script<bool>(context, "lazy.sub.fun = 1; lazy.sub.fun === 1"));
+	check_eq("lazy.rprop", run_script<int>(context, "lazy.rprop"), 3);
 }
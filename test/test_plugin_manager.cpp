@@ -0,0 +1,101 @@
+#include "v8pp/context.hpp"
+#include "v8pp/plugin_manager.hpp"
+
+#include "test.hpp"
+
+static void noop(v8::FunctionCallbackInfo<v8::Value> const&) {}
+
+static v8pp::plugin_export const exports[] =
+{
+	{ "noop", &noop, 2 },
+};
+
+void test_plugin_manager()
+{
+	v8pp::context context;
+
+	v8::HandleScope scope(context.isolate());
+
+	check("no plugin manager", v8pp::plugin_manager::get(context.isolate()) == nullptr);
+
+	v8pp::plugin_manager& plugins = v8pp::plugin_manager::instance(context.isolate());
+	check("plugin manager", v8pp::plugin_manager::get(context.isolate()) == &plugins);
+
+	plugins.set_bind_now(true);
+	plugins
+		.add("missing")
+		.add("a", { "b" })
+		.add("b", { "c" })
+		.add("c", { "a" })
+		;
+	check_eq("declared plugins", plugins.size(), 4u);
+
+	check_eq("preloaded plugins", plugins.preload(2), 0u);
+	v8pp::plugin_manager::plugin const* missing = plugins.find("missing");
+	check("missing plugin", missing != nullptr && missing->handle == nullptr);
+	check("load error", !missing->error.empty());
+
+	try
+	{
+		plugins.resolve("a");
+		check("dependency cycle", false);
+	}
+	catch (std::runtime_error const& ex)
+	{
+		check_eq("dependency cycle", std::string(ex.what()), "plugin dependency cycle: a -> b -> c -> a");
+	}
+
+	v8pp::plugin_descriptor descriptor =
+	{
+		V8PP_PLUGIN_ABI_VERSION, V8_MAJOR_VERSION, V8_MINOR_VERSION, v8pp::plugin_export_table,
+		"test", exports, 1
+	};
+	check("compatible descriptor", v8pp::plugin_manager::check_descriptor(descriptor).empty());
+	descriptor.abi_version = V8PP_PLUGIN_ABI_VERSION + 1;
+	check("incompatible ABI", !v8pp::plugin_manager::check_descriptor(descriptor).empty());
+	descriptor.abi_version = V8PP_PLUGIN_ABI_VERSION;
+	descriptor.v8_minor_version = V8_MINOR_VERSION + 1;
+	check("incompatible V8", !v8pp::plugin_manager::check_descriptor(descriptor).empty());
+	descriptor.v8_minor_version = V8_MINOR_VERSION;
+	descriptor.required_capabilities = 1u << 31;
+	check_eq("unsupported capability", v8pp::plugin_manager::check_descriptor(descriptor),
+		"plugin requires unsupported capabilities 2147483648");
+
+	check("require error", run_script<bool>(context,
+		"var error; try { require('missing') } catch (ex) { error = ex } error !== undefined"));
+	check("undeclared plugin", plugins.find("unknown") == nullptr);
+	context.run_script("try { require('unknown') } catch (ex) {}");
+	check("undeclared plugin added", plugins.find("unknown") != nullptr);
+
+	// plugin libraries are built in the current directory,
+	// the plugin manager has no own library path
+	context.set_lib_path("no_such_dir");
+	context.run_script("try { require('file') } catch (ex) {}");
+	check("file plugin load error", !plugins.find("file")->error.empty());
+	context.set_lib_path(".");
+	check("file plugin", run_script<bool>(context, "typeof require('file').writer === 'function'"));
+	v8pp::plugin_manager::plugin const* file = plugins.find("file");
+	check("file plugin loaded", file != nullptr && file->handle != nullptr && file->error.empty());
+	check("file plugin in context library path", file->filename.compare(0, 1, ".") == 0);
+
+	check("console plugin", run_script<bool>(context, "typeof require('console').log === 'function'"));
+	void* const console_handle = plugins.find("console")->handle;
+	{
+		v8pp::context other(context.isolate());
+		check("other context console plugin", run_script<bool>(other,
+			"c = require('console'); c.x = 1; typeof c.log === 'function'"));
+		check("console library shared", plugins.find("console")->handle == console_handle);
+		check("own console exports", run_script<bool>(context, "require('console').x === undefined"));
+	}
+
+	check("console plugin descriptor", plugins.find("console")->descriptor != nullptr);
+	check_eq("console log length", run_script<int>(context, "require('console').log.length"), 0);
+	check("console log created once", run_script<bool>(context,
+		"c = require('console'); c.log === c.log && c.log.name === 'log'"));
+
+	check("incompatible plugin", run_script<bool>(context,
+		"var error; try { require('incompatible') } catch (ex) { error = ex } error !== undefined"));
+	v8pp::plugin_manager::plugin const* incompatible = plugins.find("incompatible");
+	check("incompatible plugin not loaded", incompatible != nullptr && incompatible->handle == nullptr);
+	check("incompatible plugin error", incompatible->error.find("incompatible plugin ABI version") == 0);
+}
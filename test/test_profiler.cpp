@@ -0,0 +1,38 @@
+#include "v8pp/context.hpp"
+#include "v8pp/module.hpp"
+#include "v8pp/profiler.hpp"
+
+#include "test.hpp"
+
+static int add(int x, int y) { return x + y; }
+
+void test_profiler()
+{
+	v8pp::context context;
+
+	v8::HandleScope scope(context.isolate());
+
+	v8pp::module module(context.isolate());
+	module.set("add", &add);
+	context.set("module", module);
+
+	v8pp::profiler::enable(context.isolate(), true);
+	check_eq("calls", context.run_script("var s = 0; for (var i = 0; i < 10; ++i) s = module.add(s, i); s")->Int32Value(), 45);
+	v8pp::profiler::enable(context.isolate(), false);
+
+	v8pp::profiler* profiler = v8pp::profiler::get(context.isolate());
+	check("profiler", profiler != nullptr);
+
+	std::string const json = profiler->to_json();
+	std::string const folded = profiler->to_folded();
+#if defined(V8PP_ENABLE_PROFILER)
+	check("json record", json.find("{\"name\":\"add\",\"operation\":\"call\",\"calls\":10,") != std::string::npos);
+	check("folded record", folded.find("add;call ") == 0);
+#else
+	check_eq("no records", json, "[\n]\n");
+	check("no folded records", folded.empty());
+#endif
+
+	profiler->reset();
+	check_eq("reset", profiler->to_json(), "[\n]\n");
+}
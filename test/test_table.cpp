@@ -0,0 +1,66 @@
+#include "v8pp/context.hpp"
+#include "v8pp/table.hpp"
+
+#include "test.hpp"
+
+struct quotes
+{
+	std::vector<double> price = { 1.5, 2.5, 3.0 };
+	std::vector<int32_t> volume = { 10, 20 };
+
+	double* price_data() { return price.data(); }
+	size_t price_size() const { return price.size(); }
+
+	int32_t* volume_data() { return volume.data(); }
+	size_t volume_size() const { return volume.size(); }
+
+	size_t rows() const { return price.size(); }
+};
+
+struct ticks
+{
+	double price[2] = { 0.5, 1.0 };
+
+	double* price_data() { return price; }
+	size_t price_size() const { return 2; }
+};
+
+void test_table()
+{
+	v8pp::context context;
+	v8::Isolate* isolate = context.isolate();
+	v8::HandleScope scope(isolate);
+
+	v8pp::class_<quotes> quotes_class(isolate);
+	quotes_class.ctor();
+
+	v8pp::table_<quotes>(quotes_class, &quotes::rows)
+		.column("price", &quotes::price_data, &quotes::price_size)
+		.column("volume", &quotes::volume_data, &quotes::volume_size)
+		;
+	context.set("quotes", quotes_class);
+
+	check_eq("length", run_script<int>(context, "t = new quotes(); t.length"), 3);
+	check_eq("typed array column", run_script<bool>(context, "t.price instanceof Float64Array && t.volume instanceof Int32Array"), true);
+	check_eq("typed array column value", run_script<double>(context, "t.price[1]"), 2.5);
+	check_eq("typed array column cached", run_script<bool>(context, "t.price === t.price"), true);
+	run_script<int>(context, "p = new quotes().price; 0");
+	isolate->RequestGarbageCollectionForTesting(v8::Isolate::GarbageCollectionType::kFullGarbageCollection);
+	check_eq("typed array column keeps table", run_script<double>(context, "p[1]"), 2.5);
+	check_eq("row proxy", run_script<double>(context, "r = t.row(1); r.price * r.volume"), 50.0);
+	check_eq("row index", run_script<int>(context, "r.index"), 1);
+	check_eq("row out of column", run_script<bool>(context, "t.row(2).volume === undefined"), true);
+	check_eq("row scan", run_script<double>(context,
+		"sum = 0; r = t.row(0); for (i = 0; i < t.length; ++i) { r.index = i; sum += r.price; } sum"), 7.0);
+	check_eq("row is not a wrapper", v8pp::class_<quotes>::unwrap_object(isolate, context.run_script("r")) == nullptr, true);
+
+	v8pp::class_<ticks> ticks_class(isolate);
+	ticks_class.ctor();
+	v8pp::table_<ticks>(ticks_class, &ticks::price_size)
+		.column("price", &ticks::price_data, &ticks::price_size)
+		;
+	check_eq("table class not materialized", v8pp::detail::class_singleton<ticks>::instance(isolate).materialized(), false);
+	ticks_class.set_inline_values(16);
+	context.set("ticks", ticks_class);
+	check_eq("table with inline values", run_script<double>(context, "t = new ticks(); t.row(1).price * t.length"), 2.0);
+}
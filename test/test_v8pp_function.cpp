@@ -5,6 +5,8 @@
 #include "v8pp/any_object_hidden.h"
 #include "v8pp/function.hpp"
 
+#include <vector>
+
 bool ran = false;
 
 void function_to_call()
@@ -27,7 +29,6 @@ void test_functional()
 	v8pp::Function<void()> v8_func = run_script<v8pp::Function<void()>>(context,
 		"var function_test_ran = false; function test_v8_function(){function_test_ran = true;};test_v8_function;");
 	check_eq("Getting function from v8", v8_func.is_v8_function(), true);
-	v8_func.set_v8_forward_function(v8pp::forward_functional<void>);
 	v8_func();//v8::Handle<v8::Value>::Cast(context.global()));
 	check_eq("V8 function ran from cpp", run_script<bool>(context, "function_test_ran;"), true);
 
@@ -41,8 +42,60 @@ void test_functional()
 	v8pp::Function<void(int)> v8_func2 = run_script<v8pp::Function<void(int)>>(context,
 		"var int_result = 0; function test_v8_function2(int_pass){int_result = int_pass;};test_v8_function2;");
 
-	v8_func2.set_v8_forward_function(v8pp::forward_functional<void, int>);
 	v8_func2(v8::Handle<v8::Value>::Cast(context.global()), 2);
 
 	check_eq("v8 function call with args", run_script<int>(context, "int_result;"), 2);
-}
\ No newline at end of file
+
+	v8pp::Function<int(int)> v8_func3 = run_script<v8pp::Function<int(int)>>(context,
+		"(function(x) { return x * 2; })");
+	check_eq("v8 function result", v8_func3(21), 42);
+
+	v8pp::Function<int(int)> copy = v8_func3;
+	check_eq("copied v8 function", copy(2), 4);
+
+	int offset = 10;
+	v8pp::Function<int(int)> in_place = [offset](int x) { return x + offset; };
+	check_eq("in place callable", in_place(1), 11);
+
+	std::string const suffix = "suffix";
+	v8pp::Function<std::string(std::string)> on_heap = [suffix](std::string const& str) { return str + suffix; };
+	v8pp::Function<std::string(std::string)> heap_copy;
+	heap_copy = on_heap;
+	check_eq("heap callable", heap_copy("a"), "asuffix");
+
+	in_place.reset();
+	check("reset function", in_place.isEmpty());
+}
+
+void test_persistent_value()
+{
+	v8pp::PersistentValue outlived;
+	v8pp::Function<int()> outlived_function;
+	{
+		v8pp::context context;
+		v8::Isolate* isolate = context.isolate();
+		v8::HandleScope scope(isolate);
+
+		v8::Local<v8::Value> value = v8pp::to_v8(isolate, 42);
+		v8pp::PersistentValue persistent(value, isolate);
+		v8pp::PersistentValue copy = persistent;
+		check_eq("copied value", copy.get_value()->Int32Value(), 42);
+
+		std::vector<v8pp::PersistentValue> values(100, persistent);
+		values.erase(values.begin() + 10, values.begin() + 90);
+		check_eq("value in vector", values.back().get_value()->Int32Value(), 42);
+		check_eq("copies share slot", v8pp::persistent_table::get(isolate)->count(), 1u);
+
+		v8::Local<v8::Value> one = v8pp::to_v8(isolate, 1);
+		v8pp::PersistentValue other(one, isolate);
+		check_eq("new slot", v8pp::persistent_table::get(isolate)->count(), 2u);
+		other = persistent;
+		check_eq("released slot", v8pp::persistent_table::get(isolate)->count(), 1u);
+
+		outlived = persistent;
+		outlived_function = run_script<v8pp::Function<int()>>(context, "(function() { return 1; })");
+		check("function set", outlived_function.is_v8_function());
+	}
+	check("value reset on isolate disposal", outlived.isEmpty());
+	check("function reset on isolate disposal", !outlived_function.is_v8_function());
+}
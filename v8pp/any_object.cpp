@@ -3,64 +3,147 @@
 namespace v8pp
 {
 	std::map<v8::Isolate *, value_watcher> value_watcher::watcher_per_isolate;
-	void PersistentValue::data_object::set_value(v8::Local<v8::Value> &obj, v8::Isolate *isolate)
+
+	std::map<v8::Isolate *, persistent_table *> persistent_table::attached_;
+	std::vector<persistent_table *> persistent_table::detached_;
+	std::atomic<uint32_t> persistent_table::next_generation_(1);
+
+	uint32_t const persistent_table::chunk_bits;
+	uint32_t const persistent_table::chunk_size;
+	uint32_t const persistent_table::no_slot;
+
+	persistent_table *persistent_table::get(v8::Isolate *isolate)
 	{
-		_isolate = isolate;
-		base_object.Reset(_isolate, obj);
+		auto finder = attached_.find(isolate);
+		if (finder != attached_.end())
+			return finder->second;
+
+		persistent_table *table;
+		if (detached_.empty())
+		{
+			table = new persistent_table;
+		}
+		else
+		{
+			table = detached_.back();
+			detached_.pop_back();
+		}
+		table->isolate_ = isolate;
+		attached_.emplace(isolate, table);
+		return table;
 	}
 
-	bool PersistentValue::data_object::isEmpty()
+	void persistent_table::delete_isolate_instance(v8::Isolate *isolate)
 	{
-		if (base_object.IsEmpty())
-			return true;
-		return false;
-	} 
+		auto finder = attached_.find(isolate);
+		if (finder == attached_.end())
+			return;
 
-	void PersistentValue::set_value(v8::Local<v8::Value> &value, v8::Isolate *isolate)
+		persistent_table *table = finder->second;
+		attached_.erase(finder);
+		table->clear();
+		detached_.push_back(table);
+	}
+
+	uint32_t persistent_table::acquire(v8::Local<v8::Value> value, uint32_t &generation)
 	{
-		object->set_value(value, isolate);
+		uint32_t index = free_head_;
+		if (index != no_slot)
+		{
+			free_head_ = at(index).next_free;
+		}
+		else
+		{
+			if ((size_ & (chunk_size - 1)) == 0)
+				chunks_.emplace_back(new slot[chunk_size]);
+			index = size_++;
+		}
 
-		value_watcher::emplace_data(isolate, this);
+		slot &s = at(index);
+		s.value.Reset(isolate_, value);
+		s.generation = generation = next_generation_++;
+		s.refs = 1;
+		++used_;
+		return index;
 	}
 
-	bool PersistentValue::isEmpty()
+	void persistent_table::release(uint32_t index)
 	{
-		return object->isEmpty();
+		slot &s = at(index);
+		if (--s.refs == 0)
+		{
+			s.value.Reset();
+			s.next_free = free_head_;
+			free_head_ = index;
+			--used_;
+		}
 	}
 
-	v8::Isolate *PersistentValue::data_object::get_isolate()
+	void persistent_table::clear()
 	{
-		if (isEmpty())
-			return nullptr;
-		return _isolate;
+		for (uint32_t index = 0; index < size_; ++index)
+			at(index).value.Reset();
+
+		// size_ == 0 makes all values of the table invalid
+		chunks_.clear();
+		size_ = used_ = 0;
+		free_head_ = no_slot;
+		isolate_ = nullptr;
 	}
 
-	v8::Isolate *PersistentValue::get_isolate() const
+	bool PersistentValue::is_valid() const
 	{
-		return object->get_isolate();
+		return table_ && table_->is_valid(index_, generation_);
 	}
 
-	v8::Local<v8::Value> PersistentValue::data_object::get_value()
+	void PersistentValue::set_value(v8::Local<v8::Value> &value, v8::Isolate *isolate)
 	{
-		if ((_isolate == nullptr) || (base_object.IsEmpty()))
-			return v8::Local<v8::Value>();
+		destroy_value();
+		if (isolate == nullptr || value.IsEmpty())
+			return;
 
-		return v8pp::to_local(_isolate, base_object);
+		table_ = persistent_table::get(isolate);
+		index_ = table_->acquire(value, generation_);
+	}
+
+	bool PersistentValue::isEmpty()
+	{
+		return !is_valid();
+	}
+
+	v8::Isolate *PersistentValue::get_isolate() const
+	{
+		if (!is_valid())
+			return nullptr;
+		return table_->isolate();
 	}
 
 	v8::Local<v8::Value> PersistentValue::get_value() const
 	{
-		return object->get_value();
+		if (!is_valid())
+			return v8::Local<v8::Value>();
+		return table_->get(index_);
 	}
 
 	void PersistentValue::destroy_value()
 	{
-		object.reset(new data_object());
+		if (is_valid())
+			table_->release(index_);
+		table_ = nullptr;
+		index_ = generation_ = 0;
 	}
 
 	PersistentValue& PersistentValue::operator=(const PersistentValue &other)
 	{
-		set_value(other.get_value(), other.get_isolate());
+		if (other.is_valid())
+			other.table_->add_ref(other.index_);
+		destroy_value();
+		if (other.is_valid())
+		{
+			table_ = other.table_;
+			index_ = other.index_;
+			generation_ = other.generation_;
+		}
 		return *this;
 	}
 	PersistentValue& PersistentValue::operator=(const ValueIsolate &other)
@@ -70,40 +153,34 @@ namespace v8pp
 		return *this;
 	}
 
-
-	PersistentValue::data_object::~data_object()
+	PersistentValue::PersistentValue(PersistentValue const &other) : table_(nullptr), index_(0), generation_(0)
 	{
-		if (_isolate != nullptr)
+		if (other.is_valid())
 		{
-			base_object.Reset();
-			_isolate = nullptr;
+			other.table_->add_ref(other.index_);
+			table_ = other.table_;
+			index_ = other.index_;
+			generation_ = other.generation_;
 		}
 	}
-	PersistentValue::PersistentValue(PersistentValue const &other) : object(new data_object())
-	{
-		if (!other.object->isEmpty())
-			set_value(other.object->get_value(), other.object->get_isolate());
-	}
 
-	PersistentValue::PersistentValue() : object(new data_object())
+	PersistentValue::PersistentValue() : table_(nullptr), index_(0), generation_(0)
 	{
 	}
 
-	PersistentValue::PersistentValue(v8::Local<v8::Value> &value, v8::Isolate *isolate) : object(new data_object())
+	PersistentValue::PersistentValue(v8::Local<v8::Value> &value, v8::Isolate *isolate) : table_(nullptr), index_(0), generation_(0)
 	{
 		set_value(value, isolate);
 	}
 
-	PersistentValue::PersistentValue(const ValueIsolate &v8_value_isolate) : object(new data_object())
+	PersistentValue::PersistentValue(const ValueIsolate &v8_value_isolate) : table_(nullptr), index_(0), generation_(0)
 	{
 		set_value(v8_value_isolate.get_value(), v8_value_isolate.get_isolate());
 	}
 
 	PersistentValue::~PersistentValue()
 	{
-		if (!object->isEmpty())
-			value_watcher::remove_data(object->get_isolate(), this);
-		object.reset();
+		destroy_value();
 	}
 
 	ValueIsolate::data_object::data_object(v8::Local<v8::Value> &value, v8::Isolate *isolate)
@@ -154,20 +231,17 @@ namespace v8pp
 	//v8pp function
 	function_base::function_base()
 	{
-		_d.reset(new function_data);
 	}
 
 	function_base::function_base(v8::Local<v8::Function> &function, v8::Isolate *isolate)
 	{
-		_d.reset(new function_data);
 		set_v8_function(function, isolate);
 	}
 
 	function_base::function_base(const function_base &other)
 	{
-		_d.reset(new function_data);
-		if (!other._d->isEmpty())
-			_d->set_value(other._d->get_function(), other._d->get_isolate());
+		if (other.is_v8_function())
+			set_v8_function(other._d->get_function(), other._d->get_isolate());
 	}
 
 	function_base::~function_base()
@@ -175,8 +249,23 @@ namespace v8pp
 		_d.reset();
 	}
 
+	function_base& function_base::operator=(const function_base &other)
+	{
+		if (this != &other)
+		{
+			if (other.is_v8_function())
+				set_v8_function(other._d->get_function(), other._d->get_isolate());
+			else
+				reset();
+		}
+		return *this;
+	}
+
 	void function_base::set_v8_function(v8::Local<v8::Function> &function, v8::Isolate *isolate)
 	{
+		// function data is allocated only for v8 functions
+		if (!_d)
+			_d.reset(new function_data);
 		_d->set_value(function, isolate);
 	}
 
@@ -187,18 +276,18 @@ namespace v8pp
 
 	bool function_base::is_v8_function() const
 	{
-		return !_d->isEmpty();
+		return _d && !_d->isEmpty();
 	}
 
 	void function_base::reset()
 	{
-		_d->reset();
+		if (_d)
+			_d->reset();
 	}
 
 	function_data::~function_data()
 	{
-		if (isolate_ != nullptr)
-			value_watcher::remove_data(isolate_, this);
+		reset();
 	}
 
 	bool function_data::isEmpty()
@@ -208,14 +297,18 @@ namespace v8pp
 
 	void function_data::set_value(v8::Local<v8::Function> &function, v8::Isolate *isolate)
 	{
+		if (isolate_ != isolate)
+		{
+			value_watcher::unlink(this);
+			value_watcher::get_value_watcher(isolate)->link(this);
+		}
 		function_.Reset(isolate, function);
 		isolate_ = isolate;
-
-		value_watcher::emplace_data(isolate_, this);
 	}
 
 	void function_data::reset()
 	{
+		value_watcher::unlink(this);
 		function_.Reset();
 		isolate_ = nullptr;
 	}
@@ -243,55 +336,19 @@ namespace v8pp
 	}
 
 
-	void value_watcher::emplace_data(v8::Isolate *isolate, PersistentValue *data)
-	{
-		value_watcher *e_info = get_value_watcher(isolate);
-		e_info->value_map.emplace(data, true);
-	}
-
-	void value_watcher::remove_data(v8::Isolate *isolate, PersistentValue *data)
-	{
-		value_watcher *e_info = get_value_watcher(isolate);
-
-		auto it = e_info->value_map.find(data);
-		if (it != e_info->value_map.end())
-			e_info->value_map.erase(it);
-	}
-
-	void value_watcher::emplace_data(v8::Isolate *isolate, function_data *data)
-	{
-		value_watcher *e_info = get_value_watcher(isolate);
-		e_info->function_map.emplace(data, true);
-	}
-
-	void value_watcher::remove_data(v8::Isolate *isolate, function_data *data)
-	{
-		value_watcher *e_info = get_value_watcher(isolate);
-
-		auto it = e_info->function_map.find(data);
-		if (it != e_info->function_map.end())
-			e_info->function_map.erase(it);
-	}
 	void value_watcher::delete_isolate_instance(v8::Isolate *isolate)
 	{
-		value_watcher *e_info = get_value_watcher(isolate);
+		persistent_table::delete_isolate_instance(isolate);
 
-		auto it = e_info->value_map.begin();
-		for (; it != e_info->value_map.end();)
-		{
-			it->first->destroy_value();
-			it = e_info->value_map.erase(it);
-		}
+		auto finder = watcher_per_isolate.find(isolate);
+		if (finder == watcher_per_isolate.end())
+			return;
 
-		auto f_it = e_info->function_map.begin();
-		for (; f_it != e_info->function_map.end(); f_it++)
-		{
-			f_it->first->reset();
-			f_it = e_info->function_map.erase(f_it);
-		}
+		// reset() unlinks the first item
+		value_watcher &watcher = finder->second;
+		while (watcher.functions_)
+			watcher.functions_->reset();
 
-		auto finder = watcher_per_isolate.find(isolate);
-		if (finder != watcher_per_isolate.end())
-			watcher_per_isolate.erase(finder);
+		watcher_per_isolate.erase(finder);
 	}
 };
\ No newline at end of file
@@ -1,9 +1,12 @@
 #ifndef V8PP_ANY_OBJECT_H_INCLUDED
 #define V8PP_ANY_OBJECT_H_INCLUDED
 
+#include <cstdint>
 #include <memory>
 #include "reference_tracker.h"
 #include <functional>
+#include <new>
+#include <type_traits>
 
 namespace v8
 {
@@ -62,7 +65,11 @@ namespace v8pp
 		std::unique_ptr<data_object> _d;
 	};
 
+	class persistent_table;
+
 	//stores persistent v8 value and its isolate
+	//	- the value is a slot in the persistent_table of the isolate, copies share the slot
+	//	- the value becomes empty on isolate destruction
 	class PersistentValue : public ref_debug<PersistentValue>
 	{
 	public:
@@ -85,8 +92,11 @@ namespace v8pp
 		PersistentValue& operator=(const PersistentValue &other);
 		PersistentValue& operator=(const ValueIsolate &other);
 	private:
-		struct data_object;
-		std::unique_ptr<data_object> object;
+		bool is_valid() const;
+
+		persistent_table *table_;
+		uint32_t index_;
+		uint32_t generation_;
 	};
 
 	//v8 function or cpp function
@@ -103,6 +113,8 @@ namespace v8pp
 		function_base(const function_base &other);
 		~function_base();
 
+		function_base& operator=(const function_base &other);
+
 		bool is_v8_function() const;
 
 		virtual bool is_cpp_function() const = 0;
@@ -113,19 +125,31 @@ namespace v8pp
 
 		void set_v8_function(v8::Local<v8::Function> &function, v8::Isolate *isolate);
 
+		// nullptr until a v8 function is set
 		function_data *get_data() const;
 	protected:
 		std::unique_ptr<function_data> _d;
 	};
 
+	namespace detail
+	{
+		//
+		//		Calls the v8 function stored in function_base, defined in any_object_hidden.h
+		//			- empty this_object calls the function with the global object as `this`
+		//			- convert.hpp includes the definition for conversions of v8 functions to Function
+		//
+		template<class _Ret, class... ArgTypes>
+		_Ret v8_function_stub(function_base const &function, v8::Local<v8::Value> const *this_object, ArgTypes... args);
+	}
 
 	template<class T> class Function { };
 
 	//
 	//
-	//		To call a stored v8 function you should first set the v8_forward_function
-	//			- setting it manually allows for the v8 headers to be hidden
-	//			- template functions would be compiled when needed
+	//		Stores a v8 function or a cpp callable
+	//			- a call is one indirect call through the invoker selected on assignment
+	//			- callables up to buffer_size bytes are stored in place, larger ones on the heap
+	//			- v8 functions are called with detail::v8_function_stub, no forwarder needs to be set
 	//
 	//
 	template<class _Ret, class... ArgTypes>
@@ -134,48 +158,74 @@ namespace v8pp
 	public:
 		typedef Function<_Ret(ArgTypes...)> class_type;
 		typedef std::function<_Ret(ArgTypes...)> std_function_type;
-		typedef std::function<_Ret(class_type *, v8::Local<v8::Value>, ArgTypes...)> v8_forward_function;
-		
-		Function() : function_base()
+
+		static size_t const buffer_size = 3 * sizeof(void*);
+
+		Function() : function_base(), invoke_(nullptr), manage_(nullptr)
 		{
 
 		}
-		Function(v8::Local<v8::Function> &function, v8::Isolate *isolate) : function_base(function, isolate)
+		Function(v8::Local<v8::Function> &function, v8::Isolate *isolate) : function_base(function, isolate),
+			invoke_(&detail::v8_function_stub<_Ret, ArgTypes...>), manage_(nullptr)
 		{
 
 		}
+		template<typename F, typename = typename std::enable_if<!std::is_base_of<function_base, typename std::decay<F>::type>::value>::type>
+		Function(F &&function) : function_base(), invoke_(nullptr), manage_(nullptr)
+		{
+			store(std::forward<F>(function));
+		}
+		Function(const class_type &other) : function_base(other), invoke_(other.invoke_), manage_(nullptr)
+		{
+			copy_callable(other);
+		}
+		~Function()
+		{
+			destroy_callable();
+		}
 
-		_Ret operator()(ArgTypes... args)
-		{ 
-			if (is_v8_function() && v8_function)
-				return v8_function(this, v8::Local<v8::Value>(), std::forward<ArgTypes>(args)...);
-			return cpp_function(std::forward<ArgTypes>(args)...);
-		};
-		
-		_Ret operator()(v8::Local<v8::Value> &this_object, ArgTypes... args)
+		class_type& operator=(const class_type &other)
 		{
-			return v8_function(this, this_object, std::forward<ArgTypes>(args)...);
+			if (this != &other)
+			{
+				destroy_callable();
+				function_base::operator=(other);
+				invoke_ = other.invoke_;
+				copy_callable(other);
+			}
+			return *this;
 		}
 
-		void operator=(std_function_type function)
+		template<typename F>
+		typename std::enable_if<!std::is_base_of<function_base, typename std::decay<F>::type>::value, class_type&>::type
+			operator=(F &&function)
 		{
 			reset();
-			cpp_function = function; 
+			store(std::forward<F>(function));
+			return *this;
+		}
+
+		_Ret operator()(ArgTypes... args) const
+		{
+			if (!invoke_)
+				throw std::bad_function_call();
+			return invoke_(*this, nullptr, std::forward<ArgTypes>(args)...);
 		};
 
-		/*
-			should use the function_data_forward defined in any_object_hidden.h
+		// this_object is used only by v8 functions
+		_Ret operator()(v8::Local<v8::Value> const &this_object, ArgTypes... args) const
+		{
+			if (!invoke_)
+				throw std::bad_function_call();
+			return invoke_(*this, &this_object, std::forward<ArgTypes>(args)...);
+		}
 
-			ex. 
-				forward_struct<_Ret(ArgTypes...)>::function_data_forward<_Ret>
-			or
-				forward_functional<_Ret, Args..>
-					-- contains no brackets
-		*/
-		void set_v8_forward_function(v8_forward_function function)
+		void reset()
 		{
-			v8_function = function;
-		};
+			function_base::reset();
+			destroy_callable();
+			invoke_ = nullptr;
+		}
 
 		virtual bool isEmpty() const
 		{
@@ -195,20 +245,115 @@ namespace v8pp
 
 		virtual bool is_cpp_function() const
 		{
-			if (cpp_function)
-				return true;
-			return false;
+			return manage_ != nullptr;
 		}
 
 		std_function_type get_cpp_function() const
 		{
-			return cpp_function;
+			if (!is_cpp_function())
+				return std_function_type();
+			return std_function_type(*this);
 		}
 	private:
-		std_function_type cpp_function;
-		v8_forward_function v8_function;
+		typedef typename std::aligned_storage<buffer_size>::type buffer_type;
+		typedef _Ret(*invoker)(function_base const &, v8::Local<v8::Value> const *, ArgTypes...);
+		// copy constructs src into dst, or destroys dst if src is nullptr
+		typedef void(*manager)(buffer_type &dst, buffer_type const *src);
+
+		template<typename F>
+		struct is_in_place : std::integral_constant<bool, sizeof(F) <= buffer_size
+			&& std::alignment_of<buffer_type>::value % std::alignment_of<F>::value == 0> {};
+
+		template<typename F>
+		static F& target(buffer_type &buffer, std::true_type /*in_place*/)
+		{
+			return *reinterpret_cast<F*>(&buffer);
+		}
+
+		template<typename F>
+		static F& target(buffer_type &buffer, std::false_type /*in_place*/)
+		{
+			return **reinterpret_cast<F**>(&buffer);
+		}
+
+		template<typename F>
+		static _Ret cpp_stub(function_base const &function, v8::Local<v8::Value> const *, ArgTypes... args)
+		{
+			buffer_type &buffer = static_cast<class_type const &>(function).buffer_;
+			return static_cast<_Ret>(target<F>(buffer, is_in_place<F>())(std::forward<ArgTypes>(args)...));
+		}
+
+		template<typename F>
+		static void manage(buffer_type &dst, buffer_type const *src)
+		{
+			manage<F>(dst, src, is_in_place<F>());
+		}
+
+		template<typename F>
+		static void manage(buffer_type &dst, buffer_type const *src, std::true_type /*in_place*/)
+		{
+			if (src)
+				new (&dst) F(*reinterpret_cast<F const*>(src));
+			else
+				reinterpret_cast<F*>(&dst)->~F();
+		}
+
+		template<typename F>
+		static void manage(buffer_type &dst, buffer_type const *src, std::false_type /*in_place*/)
+		{
+			if (src)
+				*reinterpret_cast<F**>(&dst) = new F(**reinterpret_cast<F* const*>(src));
+			else
+				delete *reinterpret_cast<F**>(&dst);
+		}
+
+		template<typename F>
+		void store(F &&function)
+		{
+			typedef typename std::decay<F>::type callable;
+			construct<callable>(std::forward<F>(function), is_in_place<callable>());
+			invoke_ = &cpp_stub<callable>;
+			manage_ = &manage<callable>;
+		}
+
+		template<typename Callable, typename F>
+		void construct(F &&function, std::true_type /*in_place*/)
+		{
+			new (&buffer_) Callable(std::forward<F>(function));
+		}
+
+		template<typename Callable, typename F>
+		void construct(F &&function, std::false_type /*in_place*/)
+		{
+			*reinterpret_cast<Callable**>(&buffer_) = new Callable(std::forward<F>(function));
+		}
+
+		void copy_callable(const class_type &other)
+		{
+			if (other.manage_)
+			{
+				other.manage_(buffer_, &other.buffer_);
+				manage_ = other.manage_;
+			}
+		}
+
+		void destroy_callable()
+		{
+			if (manage_)
+			{
+				manage_(buffer_, nullptr);
+				manage_ = nullptr;
+			}
+		}
+
+		invoker invoke_;
+		manager manage_;
+		mutable buffer_type buffer_;
 	};
 
+	template<class _Ret, class... ArgTypes>
+	size_t const Function<_Ret(ArgTypes...)>::buffer_size;
+
 
 	/*
 		Any value should try to store a v8 object
@@ -5,7 +5,9 @@
 #include "v8.h"
 #include <v8pp/convert.hpp>
 #include <v8pp/call_v8.hpp>
+#include <atomic>
 #include <map>
+#include <vector>
 
 namespace v8pp
 {
@@ -27,24 +29,94 @@ namespace v8pp
 				- needs to open up more v8pp functions
 				- convert functions
 	*/
-	struct PersistentValue::data_object
+	class value_watcher;
+
+	//
+	//		Hook of an intrusive doubly-linked list in the value_watcher of an isolate
+	//			- linking and unlinking are O(1) and don't allocate
+	//
+	template<typename T>
+	struct watched_hook
 	{
-		void set_value(v8::Local<v8::Value> &value, v8::Isolate *isolate);
+		value_watcher *watcher_ = nullptr;
+		T *prev_ = nullptr;
+		T *next_ = nullptr;
+	};
 
-		v8::Local<v8::Value> get_value();
+	//
+	//		Per-isolate table of persistent handles for PersistentValue
+	//			- a PersistentValue is a slot index and the slot generation
+	//			- copies share a slot with a reference count
+	//			- isolate destruction resets all slots at once, the table
+	//			  is kept for another isolate and stale values become empty
+	//			- generations are unique among all tables, a reused slot
+	//			  never matches a stale PersistentValue
+	//
+	class persistent_table
+	{
+	public:
+		// table attached to the isolate, created on first use
+		static persistent_table *get(v8::Isolate *isolate);
 
-		bool isEmpty();
+		// reset all values of the isolate and detach the table
+		static void delete_isolate_instance(v8::Isolate *isolate);
+
+		v8::Isolate *isolate() const { return isolate_; }
+
+		// new slot with one reference
+		uint32_t acquire(v8::Local<v8::Value> value, uint32_t &generation);
 
-		data_object()
+		bool is_valid(uint32_t index, uint32_t generation) const
 		{
-			_isolate = nullptr;
+			return index < size_ && at(index).refs != 0 && at(index).generation == generation;
 		}
-		~data_object();
 
-		v8::Isolate *get_isolate();
+		void add_ref(uint32_t index)
+		{
+			++at(index).refs;
+		}
+
+		void release(uint32_t index);
+
+		v8::Local<v8::Value> get(uint32_t index) const
+		{
+			return v8pp::to_local(isolate_, at(index).value);
+		}
+
+		// number of slots in use
+		size_t count() const { return used_; }
 	private:
-		v8::Persistent<v8::Value> base_object;
-		v8::Isolate *_isolate = nullptr;
+		struct slot
+		{
+			v8::Persistent<v8::Value> value;
+			uint32_t generation;
+			uint32_t refs;
+			uint32_t next_free;
+		};
+
+		static uint32_t const chunk_bits = 10;
+		static uint32_t const chunk_size = 1 << chunk_bits;
+		static uint32_t const no_slot = ~0u;
+
+		persistent_table() : isolate_(nullptr), size_(0), used_(0), free_head_(no_slot) {}
+
+		slot &at(uint32_t index) const
+		{
+			return chunks_[index >> chunk_bits][index & (chunk_size - 1)];
+		}
+
+		void clear();
+
+		v8::Isolate *isolate_;
+		std::vector<std::unique_ptr<slot[]>> chunks_;
+		uint32_t size_;
+		uint32_t used_;
+		uint32_t free_head_;
+
+		// tables are never deleted, a PersistentValue may outlive its isolate
+		static std::map<v8::Isolate *, persistent_table *> attached_;
+		static std::vector<persistent_table *> detached_;
+		static std::atomic<uint32_t> next_generation_;
 	};
 
 	struct ValueIsolate::data_object
@@ -55,7 +127,7 @@ namespace v8pp
 		v8::Isolate *_isolate;
 	};
 
-	struct function_data
+	struct function_data : watched_hook<function_data>
 	{
 		function_data(){};
 		~function_data();
@@ -88,84 +160,82 @@ namespace v8pp
 		v8::Isolate *isolate_ = nullptr;
 	};
 
-	template<class T> class forward_struct { };
-
-	template<class _Ret, class... ArgTypes>
-	struct forward_struct<_Ret(ArgTypes...)>
+	namespace detail
 	{
-
-		template<typename U = _Ret>
-		static typename std::enable_if<!std::is_same < void, U>::value, U>::type
-			function_data_forward(Function<U(ArgTypes...)> *data, v8::Local<v8::Value> &this_object, ArgTypes... args)
+		template<class _Ret, class... ArgTypes>
+		_Ret v8_function_stub(function_base const &function, v8::Local<v8::Value> const *this_object, ArgTypes... args)
 		{
-			//return data->get_data()->call<_Ret(ArgTypes...)>(this_object, std::forward<ArgTypes>(args)...);
-			function_data *fdata = data->get_data();
-			v8::Isolate *isolate = fdata->get_isolate();
+			function_data *fdata = function.get_data();
+			v8::Isolate *isolate = fdata ? fdata->get_isolate() : nullptr;
 			if (isolate == nullptr)
 				return _Ret();
 
-			if (this_object.IsEmpty())
-			{
-				this_object = isolate->GetCurrentContext()->Global();
-			}
-
-			v8::Local<v8::Value> result = v8pp::call_v8<ArgTypes...>(isolate, fdata->get_function(),
-				this_object, std::forward<ArgTypes>(args)...);
-
-			return v8pp::from_v8<_Ret>(isolate, result);
-		}
-
-		template<typename U = _Ret>
-		static typename std::enable_if<std::is_same <void, U>::value>::type
-			function_data_forward(Function<U(ArgTypes...)> *data, v8::Local<v8::Value> &this_object, ArgTypes... args)
-		{
-			function_data *fdata = data->get_data();
-			v8::Isolate *isolate = fdata->get_isolate();
-			if (isolate == nullptr)
-				return;
-
-			if (this_object.IsEmpty())
-			{
-				this_object = isolate->GetCurrentContext()->Global();
-			}
-
-			v8::Local<v8::Value> result = v8pp::call_v8<ArgTypes...>(isolate, fdata->get_function(),
-				this_object, std::forward<ArgTypes>(args)...);
+			// empty this_object is bound to the global object of the current context
+			v8::HandleScope scope(isolate);
+			bound_function<_Ret(ArgTypes...)> const bound(isolate, fdata->get_function(),
+				this_object ? *this_object : v8::Local<v8::Value>());
+			return bound(std::forward<ArgTypes>(args)...);
 		}
-	};
-
-
-	template<class _Ret, class... ArgTypes>
-	_Ret forward_functional(Function<_Ret(ArgTypes...)> *data, v8::Local<v8::Value> &this_object, ArgTypes... args)
-	{
-		return forward_struct<_Ret(ArgTypes...)>::function_data_forward<_Ret>(data, this_object, std::forward<ArgTypes>(args)...);
 	}
 
+	//
+	//		Tracks Function values of an isolate to reset them on isolate destruction,
+	//		PersistentValue slots are reset by persistent_table
+	//
 	class value_watcher
 	{
 	public:
 		static value_watcher *get_value_watcher(v8::Isolate *isolate);
 
-
-		static void emplace_data(v8::Isolate *isolate, PersistentValue *data);
-
-		static void remove_data(v8::Isolate *isolate, PersistentValue *data);
-
 		static void delete_isolate_instance(v8::Isolate *isolate);
 
-		static void emplace_data(v8::Isolate *isolate, function_data *data);
+		// item should not be linked
+		template<typename T>
+		void link(T *item);
 
-		static void remove_data(v8::Isolate *isolate, function_data *data);
+		// does nothing for an item that is not linked
+		template<typename T>
+		static void unlink(T *item);
 	private:
-		value_watcher(){};
+		value_watcher() : functions_(nullptr) {};
 
-		std::map<PersistentValue *, bool> value_map;
+		function_data *&head(function_data *) { return functions_; }
 
-		std::map<function_data *, bool> function_map;
+		function_data *functions_;
 
 		static std::map<v8::Isolate *, value_watcher> watcher_per_isolate;
 	};
 
+	template<typename T>
+	void value_watcher::link(T *item)
+	{
+		T *&first = head(item);
+		item->watcher_ = this;
+		item->prev_ = nullptr;
+		item->next_ = first;
+		if (first)
+			first->prev_ = item;
+		first = item;
+	}
+
+	template<typename T>
+	void value_watcher::unlink(T *item)
+	{
+		value_watcher *watcher = item->watcher_;
+		if (watcher == nullptr)
+			return;
+
+		if (item->prev_)
+			item->prev_->next_ = item->next_;
+		else
+			watcher->head(item) = item->next_;
+		if (item->next_)
+			item->next_->prev_ = item->prev_;
+
+		item->watcher_ = nullptr;
+		item->prev_ = item->next_ = nullptr;
+	}
+
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,262 @@
+#include "v8pp/array_buffer_allocator.hpp"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+namespace v8pp {
+
+namespace {
+
+char* allocate_slab(size_t size)
+{
+#if defined(WIN32)
+	// large pages require SeLockMemoryPrivilege, use regular pages
+	return static_cast<char*>(::VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+#else
+	void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (ptr == MAP_FAILED)
+	{
+		return nullptr;
+	}
+#if defined(MADV_HUGEPAGE)
+	::madvise(ptr, size, MADV_HUGEPAGE);
+#endif
+	return static_cast<char*>(ptr);
+#endif
+}
+
+void free_slab(char* ptr, size_t size)
+{
+#if defined(WIN32)
+	(void)size;
+	::VirtualFree(ptr, 0, MEM_RELEASE);
+#else
+	::munmap(ptr, size);
+#endif
+}
+
+} // unnamed namespace
+
+array_buffer_allocator::array_buffer_allocator()
+	: allocated_bytes_(0)
+	, peak_bytes_(0)
+	, allocations_(0)
+	, frees_(0)
+{
+}
+
+array_buffer_allocator::~array_buffer_allocator()
+{
+}
+
+void* array_buffer_allocator::Allocate(size_t length)
+{
+	return count_allocation(allocate_memory(length, true), length);
+}
+
+void* array_buffer_allocator::AllocateUninitialized(size_t length)
+{
+	return count_allocation(allocate_memory(length, false), length);
+}
+
+void array_buffer_allocator::Free(void* data, size_t length)
+{
+	if (data)
+	{
+		free_memory(data, length);
+		allocated_bytes_ -= length;
+		++frees_;
+	}
+}
+
+void* array_buffer_allocator::count_allocation(void* data, size_t length)
+{
+	if (data)
+	{
+		size_t const allocated = (allocated_bytes_ += length);
+		size_t peak = peak_bytes_.load();
+		while (allocated > peak && !peak_bytes_.compare_exchange_weak(peak, allocated))
+		{
+		}
+		++allocations_;
+	}
+	return data;
+}
+
+array_buffer_allocator::statistics array_buffer_allocator::stats() const
+{
+	statistics result;
+	result.allocated_bytes = allocated_bytes_.load();
+	result.peak_bytes = peak_bytes_.load();
+	result.allocations = allocations_.load();
+	result.frees = frees_.load();
+	return result;
+}
+
+void* malloc_allocator::allocate_memory(size_t length, bool zero_fill)
+{
+	return zero_fill ? calloc(length, 1) : malloc(length);
+}
+
+void malloc_allocator::free_memory(void* data, size_t)
+{
+	free(data);
+}
+
+size_t const pooled_allocator::min_block_size;
+size_t const pooled_allocator::max_block_size;
+size_t const pooled_allocator::slab_size;
+
+pooled_allocator::pooled_allocator(bool huge_pages, size_t max_cached_bytes)
+	: huge_pages_(huge_pages)
+	, max_cached_bytes_(max_cached_bytes)
+	, cached_bytes_(0)
+{
+}
+
+pooled_allocator::~pooled_allocator()
+{
+	trim();
+	for (slab& s : slabs_)
+	{
+		free_slab(s.begin, slab_size);
+	}
+}
+
+size_t pooled_allocator::size_class(size_t length)
+{
+	size_t index = 0;
+	while (class_block_size(index) < length)
+	{
+		++index;
+	}
+	return index;
+}
+
+bool pooled_allocator::in_slab(void* block) const
+{
+	char const* ptr = static_cast<char const*>(block);
+	for (slab const& s : slabs_)
+	{
+		if (ptr >= s.begin && ptr < s.begin + slab_size)
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void* pooled_allocator::new_block(size_t index)
+{
+	size_t const block_size = class_block_size(index);
+	if (huge_pages_)
+	{
+		if (slabs_.empty() || slabs_.back().used + block_size > slab_size)
+		{
+			slab s = { allocate_slab(slab_size), 0 };
+			if (s.begin)
+			{
+				slabs_.push_back(s);
+			}
+		}
+		if (!slabs_.empty() && slabs_.back().used + block_size <= slab_size)
+		{
+			slab& s = slabs_.back();
+			void* block = s.begin + s.used;
+			s.used += block_size;
+			return block;
+		}
+	}
+	return malloc(block_size);
+}
+
+void* pooled_allocator::allocate_memory(size_t length, bool zero_fill)
+{
+	if (length == 0 || length > max_block_size)
+	{
+		return zero_fill ? calloc(length, 1) : malloc(length);
+	}
+
+	size_t const index = size_class(length);
+	void* block;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		std::vector<void*>& free_list = free_lists_[index];
+		if (free_list.empty())
+		{
+			block = new_block(index);
+		}
+		else
+		{
+			block = free_list.back();
+			free_list.pop_back();
+			cached_bytes_ -= class_block_size(index);
+		}
+	}
+
+	// only the requested length is visible to JavaScript
+	if (block && zero_fill)
+	{
+		memset(block, 0, length);
+	}
+	return block;
+}
+
+void pooled_allocator::free_memory(void* data, size_t length)
+{
+	if (length == 0 || length > max_block_size)
+	{
+		free(data);
+		return;
+	}
+
+	size_t const index = size_class(length);
+	size_t const block_size = class_block_size(index);
+
+	std::lock_guard<std::mutex> lock(mutex_);
+	if (cached_bytes_ + block_size > max_cached_bytes_ && !in_slab(data))
+	{
+		free(data);
+		return;
+	}
+	free_lists_[index].push_back(data);
+	cached_bytes_ += block_size;
+}
+
+size_t pooled_allocator::cached_bytes() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return cached_bytes_;
+}
+
+void pooled_allocator::trim()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	for (size_t index = 0; index < size_class_count; ++index)
+	{
+		// keep slab blocks, they can't be released one by one
+		std::vector<void*>& free_list = free_lists_[index];
+		size_t kept = 0;
+		for (void* block : free_list)
+		{
+			if (in_slab(block))
+			{
+				free_list[kept++] = block;
+			}
+			else
+			{
+				free(block);
+				cached_bytes_ -= class_block_size(index);
+			}
+		}
+		free_list.resize(kept);
+	}
+}
+
+} // namespace v8pp
@@ -0,0 +1,119 @@
+#ifndef V8PP_ARRAY_BUFFER_ALLOCATOR_HPP_INCLUDED
+#define V8PP_ARRAY_BUFFER_ALLOCATOR_HPP_INCLUDED
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+
+#include <v8.h>
+
+namespace v8pp {
+
+/// ArrayBuffer allocator base with byte counters for monitoring.
+/// Counters are updated atomically, V8 may free buffers on a GC thread.
+class array_buffer_allocator : public v8::ArrayBuffer::Allocator
+{
+public:
+	/// Snapshot of allocator counters
+	struct statistics
+	{
+		size_t allocated_bytes;  ///< bytes in live buffers
+		size_t peak_bytes;       ///< maximum of allocated_bytes
+		size_t allocations;      ///< number of allocations made
+		size_t frees;            ///< number of buffers freed
+	};
+
+	array_buffer_allocator();
+	virtual ~array_buffer_allocator();
+
+	array_buffer_allocator(array_buffer_allocator const&) = delete;
+	array_buffer_allocator& operator=(array_buffer_allocator const&) = delete;
+
+	virtual void* Allocate(size_t length);
+	virtual void* AllocateUninitialized(size_t length);
+	virtual void Free(void* data, size_t length);
+
+	statistics stats() const;
+
+protected:
+	/// Allocate memory for a buffer, zero filled if zero_fill is set
+	virtual void* allocate_memory(size_t length, bool zero_fill) = 0;
+
+	/// Free memory allocated with allocate_memory()
+	virtual void free_memory(void* data, size_t length) = 0;
+
+private:
+	void* count_allocation(void* data, size_t length);
+
+	std::atomic<size_t> allocated_bytes_;
+	std::atomic<size_t> peak_bytes_;
+	std::atomic<size_t> allocations_;
+	std::atomic<size_t> frees_;
+};
+
+/// Allocator using C runtime heap
+class malloc_allocator : public array_buffer_allocator
+{
+protected:
+	virtual void* allocate_memory(size_t length, bool zero_fill);
+	virtual void free_memory(void* data, size_t length);
+};
+
+/// Allocator with free lists for power of two size classes from
+/// min_block_size to max_block_size, other sizes go to the C runtime heap.
+/// Freed blocks are kept for reuse up to max_cached_bytes.
+/// With huge_pages set blocks are carved from 2MB slabs backed
+/// by transparent huge pages where the OS supports it, slab memory
+/// is returned to the OS only on allocator destruction.
+class pooled_allocator : public array_buffer_allocator
+{
+public:
+	static size_t const min_block_size = 1024;
+	static size_t const max_block_size = 1024 * 1024;
+	static size_t const slab_size = 2 * 1024 * 1024;
+
+	explicit pooled_allocator(bool huge_pages = false, size_t max_cached_bytes = 64 * 1024 * 1024);
+	~pooled_allocator();
+
+	/// Bytes in free lists ready for reuse
+	size_t cached_bytes() const;
+
+	/// Release cached blocks allocated from the heap
+	void trim();
+
+protected:
+	virtual void* allocate_memory(size_t length, bool zero_fill);
+	virtual void free_memory(void* data, size_t length);
+
+private:
+	static size_t const size_class_count = 11; // 1KB .. 1MB
+
+	/// Size class index for a length in [1, max_block_size]
+	static size_t size_class(size_t length);
+	static size_t class_block_size(size_t index) { return min_block_size << index; }
+
+	/// Allocate a new block for the size class, mutex_ must be locked
+	void* new_block(size_t index);
+
+	/// Is the block carved from a slab, mutex_ must be locked
+	bool in_slab(void* block) const;
+
+	bool const huge_pages_;
+	size_t const max_cached_bytes_;
+
+	mutable std::mutex mutex_;
+	std::vector<void*> free_lists_[size_class_count];
+	size_t cached_bytes_;
+
+	struct slab
+	{
+		char* begin;
+		size_t used;
+	};
+	std::vector<slab> slabs_;
+};
+
+} // namespace v8pp
+
+#endif // V8PP_ARRAY_BUFFER_ALLOCATOR_HPP_INCLUDED
@@ -0,0 +1,95 @@
+#include "v8pp/background_deleter.hpp"
+
+namespace v8pp {
+
+background_deleter& background_deleter::instance()
+{
+	static background_deleter instance_;
+	return instance_;
+}
+
+background_deleter::background_deleter()
+	: stopped_(false)
+	, busy_(false)
+	, pending_(0)
+{
+	thread_ = std::thread(&background_deleter::run, this);
+}
+
+background_deleter::~background_deleter()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopped_ = true;
+	}
+	wakeup_.notify_one();
+	thread_.join();
+}
+
+void background_deleter::enqueue(destroy_function destroy, std::vector<void*>& objects)
+{
+	if (objects.empty())
+	{
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		pending_ += objects.size();
+		batches_.emplace_back();
+		batches_.back().destroy = destroy;
+		batches_.back().objects.swap(objects);
+	}
+	wakeup_.notify_one();
+}
+
+void background_deleter::flush()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	done_.wait(lock, [this]() { return batches_.empty() && !busy_; });
+}
+
+size_t background_deleter::pending()
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return pending_;
+}
+
+void background_deleter::run()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	for (;;)
+	{
+		// queued objects are destroyed before the thread stops
+		wakeup_.wait(lock, [this]() { return stopped_ || !batches_.empty(); });
+		if (batches_.empty())
+		{
+			return;
+		}
+
+		std::vector<batch> batches;
+		batches.swap(batches_);
+		busy_ = true;
+		lock.unlock();
+
+		size_t count = 0;
+		for (batch& b : batches)
+		{
+			for (void* object : b.objects)
+			{
+				b.destroy(object);
+			}
+			count += b.objects.size();
+		}
+
+		lock.lock();
+		busy_ = false;
+		pending_ -= count;
+		if (batches_.empty())
+		{
+			done_.notify_all();
+		}
+	}
+}
+
+} // namespace v8pp
@@ -0,0 +1,60 @@
+#ifndef V8PP_BACKGROUND_DELETER_HPP_INCLUDED
+#define V8PP_BACKGROUND_DELETER_HPP_INCLUDED
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace v8pp {
+
+/// Single thread shared by all isolates, destroys C++ objects of
+/// classes with thread-safe destructors off the isolate thread.
+/// Objects are queued in batches, one mutex lock per batch.
+class background_deleter
+{
+public:
+	using destroy_function = void (*)(void* object);
+
+	/// Process wide deleter instance, the thread starts on first use
+	static background_deleter& instance();
+
+	~background_deleter();
+
+	background_deleter(background_deleter const&) = delete;
+	background_deleter& operator=(background_deleter const&) = delete;
+
+	/// Queue objects to destroy with the function, the objects vector is cleared
+	void enqueue(destroy_function destroy, std::vector<void*>& objects);
+
+	/// Wait until all queued objects are destroyed
+	void flush();
+
+	/// Number of objects waiting for destruction
+	size_t pending();
+
+private:
+	struct batch
+	{
+		destroy_function destroy;
+		std::vector<void*> objects;
+	};
+
+	background_deleter();
+
+	void run();
+
+	std::mutex mutex_;
+	std::condition_variable wakeup_;
+	std::condition_variable done_;
+	bool stopped_;
+	bool busy_;
+	size_t pending_;
+	std::vector<batch> batches_;
+
+	std::thread thread_;
+};
+
+} // namespace v8pp
+
+#endif // V8PP_BACKGROUND_DELETER_HPP_INCLUDED
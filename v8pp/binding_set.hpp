@@ -0,0 +1,170 @@
+#ifndef V8PP_BINDING_SET_HPP_INCLUDED
+#define V8PP_BINDING_SET_HPP_INCLUDED
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <v8.h>
+
+#include "v8pp/context.hpp"
+#include "v8pp/function.hpp"
+#include "v8pp/lazy_property.hpp"
+#include "v8pp/module.hpp"
+#include "v8pp/profiler.hpp"
+
+namespace v8pp {
+
+template<typename T>
+class class_;
+
+namespace detail {
+
+template<typename T>
+struct lazy_class_function;
+
+/// Binding of a binding_set, a lazy property factory for the contexts
+struct binding_entry
+{
+	using factory = v8::Local<v8::Value>(*)(v8::Isolate*, v8::Local<v8::String>, v8::Local<v8::Value>);
+
+	factory create_value;
+	v8::UniquePersistent<v8::String> name;
+	v8::UniquePersistent<v8::Value> data;
+	v8::UniquePersistent<v8::FunctionTemplate> func;
+	v8::UniquePersistent<v8::ObjectTemplate> obj;
+
+	binding_entry()
+		: create_value(nullptr)
+	{
+	}
+
+	static v8::Local<v8::Value> create(v8::Isolate* isolate, v8::Local<v8::String> name, v8::Local<v8::Value> data)
+	{
+		binding_entry const* entry = get_external_data<binding_entry const*>(data);
+		if (entry->create_value)
+		{
+			return entry->create_value(isolate, name, data);
+		}
+		if (!entry->func.IsEmpty())
+		{
+			return to_local(isolate, entry->func)->GetFunction();
+		}
+		return to_local(isolate, entry->obj)->NewInstance();
+	}
+};
+
+} // namespace detail
+
+/// Bindings built once per isolate and installed into any number of contexts
+/// of the isolate. Templates are kept in the set, functions and objects are
+/// instantiated in a context on first access, so installation into a new
+/// context only defines accessors in its global object.
+/// The set should be destroyed after contexts it was installed into
+/// and before the isolate disposal.
+class binding_set
+{
+public:
+	explicit binding_set(v8::Isolate* isolate)
+		: isolate_(isolate)
+	{
+	}
+
+	binding_set(binding_set const&) = delete;
+	binding_set& operator=(binding_set const&) = delete;
+
+	/// v8::Isolate where the bindings belong
+	v8::Isolate* isolate() { return isolate_; }
+
+	/// Number of bindings in the set
+	size_t size() const { return entries_.size(); }
+
+	/// Set a function template with specified name
+	binding_set& set(char const* name, v8::Handle<v8::FunctionTemplate> func)
+	{
+		v8::HandleScope scope(isolate_);
+
+		detail::binding_entry& entry = add(name);
+		entry.func.Reset(isolate_, func);
+		return *this;
+	}
+
+	/// Set an object template with specified name, each context gets own instance
+	binding_set& set(char const* name, v8::Handle<v8::ObjectTemplate> obj)
+	{
+		v8::HandleScope scope(isolate_);
+
+		detail::binding_entry& entry = add(name);
+		entry.obj.Reset(isolate_, obj);
+		return *this;
+	}
+
+	/// Set a C++ function with specified name
+	template<typename Function>
+	typename std::enable_if<
+		detail::is_function_pointer<Function>::value,
+		binding_set&>::type
+	set(char const* name, Function func)
+	{
+		v8::HandleScope scope(isolate_);
+
+		v8::Handle<v8::Value> data = detail::set_external_data(isolate_, func);
+		V8PP_PROFILE_NAME(isolate_, data, nullptr, name);
+		return set(name, detail::function_template<Function>(isolate_, data));
+	}
+
+	/// Set a module with specified name, each context gets own module instance
+	binding_set& set(char const* name, module& m)
+	{
+		return set(name, m.object_template());
+	}
+
+	/// Set wrapped C++ class with specified name, the class templates
+	/// are created once in the isolate on first access from any context
+	template<typename T>
+	binding_set& set(char const* name, class_<T>& cl)
+	{
+		v8::HandleScope scope(isolate_);
+
+		cl.set_class_name(name, isolate_);
+		detail::binding_entry& entry = add(name);
+		entry.create_value = &detail::lazy_class_function<T>::create;
+		return *this;
+	}
+
+	/// Install the bindings into an object
+	void install(v8::Handle<v8::Object> obj) const
+	{
+		v8::HandleScope scope(isolate_);
+
+		for (auto const& entry : entries_)
+		{
+			detail::set_lazy_property<detail::binding_entry>(obj,
+				to_local(isolate_, entry->name), to_local(isolate_, entry->data));
+		}
+	}
+
+	/// Install the bindings into the context global object
+	void install(context& ctx) const
+	{
+		v8::HandleScope scope(isolate_);
+		install(ctx.global());
+	}
+
+private:
+	detail::binding_entry& add(char const* name)
+	{
+		std::unique_ptr<detail::binding_entry> entry(new detail::binding_entry);
+		entry->name.Reset(isolate_, v8pp::to_v8(isolate_, name));
+		entry->data.Reset(isolate_, detail::set_external_data(isolate_, entry.get()));
+		entries_.push_back(std::move(entry));
+		return *entries_.back();
+	}
+
+	v8::Isolate* isolate_;
+	std::vector<std::unique_ptr<detail::binding_entry>> entries_;
+};
+
+} // namespace v8pp
+
+#endif // V8PP_BINDING_SET_HPP_INCLUDED
@@ -6,6 +6,7 @@
 #include <v8.h>
 
 #include "v8pp/convert.hpp"
+#include "v8pp/profiler.hpp"
 #include "v8pp/utility.hpp"
 
 namespace v8pp { namespace detail {
@@ -41,6 +42,7 @@ struct call_from_v8_traits
 	static convert_type<Index>
 	arg_from_v8(v8::FunctionCallbackInfo<v8::Value> const& args)
 	{
+		V8PP_PROFILE_CONVERT(args.GetIsolate());
 		return convert<arg_type<Index>>::from_v8(args.GetIsolate(), args[Index - Offset]);
 	}
 
@@ -1,9 +1,15 @@
 #ifndef V8PP_CALL_V8_HPP_INCLUDED
 #define V8PP_CALL_V8_HPP_INCLUDED
 
+#include <iterator>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+
 #include <v8.h>
 
 #include "v8pp/convert.hpp"
+#include "v8pp/utility.hpp"
 
 namespace v8pp {
 
@@ -12,6 +18,7 @@ namespace v8pp {
 /// @param func  V8 function to call
 /// @param recv V8 object used as `this` in the function
 /// @param args...  C++ arguments to convert to JS arguments using to_v8
+/// @return function result, empty handle if the function has thrown an exception
 template<typename ...Args>
 v8::Handle<v8::Value> call_v8(v8::Isolate* isolate, v8::Handle<v8::Function> func,
 	v8::Handle<v8::Value> recv, Args... args)
@@ -22,11 +29,158 @@ v8::Handle<v8::Value> call_v8(v8::Isolate* isolate, v8::Handle<v8::Function> fun
 	// +1 to allocate array for arg_count == 0
 	v8::Handle<v8::Value> v8_args[arg_count + 1] = { to_v8(isolate, args)... };
 
-	v8::Local<v8::Value> result = func->Call(recv, arg_count, v8_args);
-
+	v8::Local<v8::Value> result;
+	if (!func->Call(isolate->GetCurrentContext(), recv, arg_count, v8_args).ToLocal(&result))
+	{
+		return v8::Handle<v8::Value>();
+	}
 	return scope.Escape(result);
 }
 
+namespace detail {
+
+template<typename T>
+struct is_local : std::false_type {};
+
+template<typename T>
+struct is_local<v8::Local<T>> : std::true_type {};
+
+} // namespace detail
+
+template<typename F>
+class bound_function;
+
+/// V8 function bound to a receiver and the current context for repeated calls from C++.
+/// Context, receiver and function handles are created once in the enclosing
+/// handle scope, so a bound_function should not outlive that scope.
+/// A JavaScript exception thrown by the function is left pending
+/// for an outer v8::TryCatch.
+/// Result type R is a C++ type, handles created in a call are released on return.
+template<typename R, typename ...Args>
+class bound_function<R(Args...)>
+{
+	static_assert(!detail::is_local<R>::value, "bound function result must be a C++ type");
+public:
+	using return_type = R;
+
+	/// Number of calls in call_batch sharing one handle scope
+	static size_t const batch_scope_size = 256;
+
+	/// Bind function to the receiver, global object of the current context if recv is empty
+	bound_function(v8::Isolate* isolate, v8::Handle<v8::Function> func,
+		v8::Handle<v8::Value> recv = v8::Handle<v8::Value>())
+		: isolate_(isolate)
+		, context_(isolate->GetCurrentContext())
+		, func_(func)
+		, recv_(recv)
+	{
+		if (recv_.IsEmpty())
+		{
+			recv_ = context_->Global();
+		}
+	}
+
+	v8::Isolate* isolate() const { return isolate_; }
+	v8::Local<v8::Function> function() const { return func_; }
+	v8::Local<v8::Value> receiver() const { return recv_; }
+
+	/// Call the function, converting the result with from_v8<R>
+	/// Throws std::runtime_error for non-void R if the function has thrown an exception
+	R operator()(Args... args) const
+	{
+		v8::HandleScope scope(isolate_);
+		return convert_result(call(args...), std::is_void<R>());
+	}
+
+	/// Call the function for each std::tuple<Args...> in arg_tuples,
+	/// handles are released every batch_scope_size calls.
+	/// Stops on the first JavaScript exception.
+	/// @return number of completed calls
+	template<typename Range>
+	size_t call_batch(Range const& arg_tuples) const
+	{
+		return batch(arg_tuples, [](v8::Local<v8::Value>) {});
+	}
+
+	/// Call the function for each std::tuple<Args...> in arg_tuples,
+	/// writing converted results of completed calls to out
+	template<typename Range, typename OutputIterator>
+	size_t call_batch(Range const& arg_tuples, OutputIterator out) const
+	{
+		static_assert(!std::is_void<R>::value, "no results for void function");
+		v8::Isolate* isolate = isolate_;
+		return batch(arg_tuples, [isolate, &out](v8::Local<v8::Value> result)
+		{
+			*out++ = from_v8<R>(isolate, result);
+		});
+	}
+
+private:
+	template<typename ...CallArgs>
+	v8::Local<v8::Value> call(CallArgs const&... args) const
+	{
+		int const arg_count = sizeof...(CallArgs);
+		// +1 to allocate array for arg_count == 0
+		v8::Handle<v8::Value> v8_args[arg_count + 1] = { to_v8(isolate_, args)... };
+
+		v8::Local<v8::Value> result;
+		func_->Call(context_, recv_, arg_count, v8_args).ToLocal(&result);
+		return result;
+	}
+
+	template<typename Tuple, size_t ...Indices>
+	v8::Local<v8::Value> call_tuple(Tuple const& args, detail::index_sequence<Indices...>) const
+	{
+		return call(std::get<Indices>(args)...);
+	}
+
+	template<typename Range, typename Consumer>
+	size_t batch(Range const& arg_tuples, Consumer&& consume) const
+	{
+		using indices = detail::make_index_sequence<sizeof...(Args)>;
+
+		size_t count = 0;
+		auto it = std::begin(arg_tuples);
+		auto const end = std::end(arg_tuples);
+		while (it != end)
+		{
+			v8::HandleScope scope(isolate_);
+			for (size_t n = 0; n < batch_scope_size && it != end; ++n, ++it)
+			{
+				v8::Local<v8::Value> result = call_tuple(*it, indices());
+				if (result.IsEmpty())
+				{
+					return count;
+				}
+				consume(result);
+				++count;
+			}
+		}
+		return count;
+	}
+
+	R convert_result(v8::Local<v8::Value> result, std::false_type /*is_void*/) const
+	{
+		if (result.IsEmpty())
+		{
+			throw std::runtime_error("bound function has thrown an exception");
+		}
+		return from_v8<R>(isolate_, result);
+	}
+
+	void convert_result(v8::Local<v8::Value>, std::true_type /*is_void*/) const
+	{
+	}
+
+	v8::Isolate* isolate_;
+	v8::Local<v8::Context> context_;
+	v8::Local<v8::Function> func_;
+	v8::Local<v8::Value> recv_;
+};
+
+template<typename R, typename ...Args>
+size_t const bound_function<R(Args...)>::batch_scope_size;
+
 } // namespace v8pp
 
 #endif // V8PP_CALL_V8_HPP_INCLUDED
@@ -2,13 +2,21 @@
 #define V8PP_CLASS_HPP_INCLUDED
 
 #include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
 #include <type_traits>
 #include <unordered_map>
 #include <vector>
 
+#include "v8pp/background_deleter.hpp"
 #include "v8pp/config.hpp"
 #include "v8pp/factory.hpp"
 #include "v8pp/function.hpp"
+#include "v8pp/indexed_storage.hpp"
+#include "v8pp/lazy_property.hpp"
 #include "v8pp/persistent.hpp"
 #include "v8pp/property.hpp"
 #include "v8pp/v8pp_debug.h"
@@ -34,8 +42,92 @@ namespace v8pp {
 template<typename T>
 class class_;
 
+/// How C++ objects owned by JavaScript are destroyed after garbage collection
+enum destroy_policy
+{
+	destroy_immediate,  ///< in the weak callback of each object
+	destroy_batched,    ///< weak callbacks queue objects, destroyed together after GC
+	destroy_background, ///< queued objects are destroyed on background_deleter thread
+	destroy_idle,       ///< queued objects are destroyed in context::idle_notification()
+};
+
 namespace detail {
 
+/// Header of a wrapped object in internal field 1: v8pp tag, storage flags
+/// and class type packed into an aligned pointer value with the lowest bit
+/// cleared, so a wrapper is validated and its class is compared without
+/// a class_info dereference
+struct wrapper_header
+{
+	static int const object_field = 0;
+	static int const header_field = 1;
+	static int const field_count = 2;
+	// wrappers of inline values keep their slab in one more field
+	static int const slab_field = 2;
+	static int const inline_field_count = 3;
+
+	enum flag
+	{
+		inline_value = 1, ///< value is stored in a slab of the wrapper
+	};
+
+	static unsigned const type_bits = 20;
+	static unsigned const flag_bits = 4;
+	static unsigned const max_types = 1u << type_bits;
+	// 7 bits tag, the shifted header fits 32-bit pointers
+	static uintptr_t const tag = 0x5b;
+
+	static void* make(unsigned type, unsigned flags)
+	{
+		uintptr_t const header = (tag << (type_bits + flag_bits)) | (flags << type_bits) | type;
+		return reinterpret_cast<void*>(header << 1);
+	}
+
+	/// Header of a wrapped object, nullptr for other objects
+	static void* get(v8::Local<v8::Object> obj)
+	{
+		int const count = obj->InternalFieldCount();
+		if (count != field_count && count != inline_field_count)
+		{
+			return nullptr;
+		}
+		void* header = obj->GetAlignedPointerFromInternalField(header_field);
+		if (!is_valid(header) || (count == inline_field_count && !(flags(header) & inline_value)))
+		{
+			return nullptr;
+		}
+		return header;
+	}
+
+	static bool is_valid(void const* header)
+	{
+		return (bits(header) >> (type_bits + flag_bits)) == tag;
+	}
+
+	static unsigned type(void const* header)
+	{
+		return static_cast<unsigned>(bits(header) & (max_types - 1));
+	}
+
+	static unsigned flags(void const* header)
+	{
+		return static_cast<unsigned>((bits(header) >> type_bits) & ((1u << flag_bits) - 1));
+	}
+
+private:
+	static uintptr_t bits(void const* header)
+	{
+		return reinterpret_cast<uintptr_t>(header) >> 1;
+	}
+};
+
+/// Small trivially copyable values can be stored inline in wrappers
+template<typename T>
+struct is_inline_value : std::integral_constant<bool,
+	std::is_trivially_copyable<T>::value && sizeof(T) <= V8PP_MAX_INLINE_VALUE_SIZE>
+{
+};
+
 class class_info : public ref_debug<class_info>
 {
 public:
@@ -53,6 +145,10 @@ public:
 
 	virtual void remove_class_info(){};
 
+	/// Destroy queued objects until the deadline,
+	/// returns true if there are no queued objects left
+	virtual bool drain_idle(std::chrono::steady_clock::time_point /*deadline*/) { return true; }
+
 	void add_base(class_info* info, cast_function cast)
 	{
 		auto it = std::find_if(bases_.begin(), bases_.end(),
@@ -66,6 +162,16 @@ public:
 		info->derivatives_.emplace_back(this);
 	}
 
+	/// class_info of the type in the isolate, nullptr if there is no one
+	static class_info* find(v8::Isolate* isolate, type_index type)
+	{
+		using singleton_instances = std::vector<void*>;
+
+		singleton_instances const* singletons =
+			static_cast<singleton_instances const*>(isolate->GetData(V8PP_ISOLATE_DATA_SLOT));
+		return singletons && type < singletons->size() ? static_cast<class_info*>((*singletons)[type]) : nullptr;
+	}
+
 	bool cast(void*& ptr, type_index type) const
 	{
 		if (type == type_ || !ptr)
@@ -97,11 +203,13 @@ public:
 		return false;
 	}
 
+	using object_entry = std::unordered_map<void*, std::pair<persistent<v8::Object>, bool>>::value_type;
+
 	template<typename T>
-	void add_object(T* object, persistent<v8::Object>&& handle, bool destroy = false)
+	object_entry& add_object(T* object, persistent<v8::Object>&& handle, bool destroy = false)
 	{
 		assert(objects_.find(object) == objects_.end() && "duplicate object");
-		objects_.emplace(object, std::make_pair(std::move(handle), destroy));
+		return *objects_.emplace(object, std::make_pair(std::move(handle), destroy)).first;
 	}
 
 	template<typename T>
@@ -178,11 +286,17 @@ protected:
 	static type_index register_class()
 	{
 		static type_index next_index = 0;
+		assert(next_index < wrapper_header::max_types && "too many classes");
 		return next_index++;
 	}
 
 	using objects_it = std::unordered_map<void*, std::pair<persistent<v8::Object>, bool>>::iterator;
 
+	void erase_object(void* object)
+	{
+		objects_.erase(object);
+	}
+
 	objects_it objects_begin()
 	{
 		return objects_.begin();
@@ -226,7 +340,34 @@ private:
 		: class_info(type)
 		, isolate_(isolate)
 		, ctor_(nullptr)
-	{
+		, value_ctor_(nullptr)
+		, materialized_(false)
+		, has_handler_(false)
+		, class_name_set_(false)
+		, promote_stable_(nullptr)
+		, promote_threshold_(0)
+		, key_candidates_(0)
+		, destroy_policy_(destroy_immediate)
+		, drain_after_gc_(false)
+		, max_pending_bytes_(0)
+		, receiver_check_(false)
+		, slab_values_(0)
+		, slab_data_(nullptr)
+		, slab_used_(0)
+		, slab_size_(0)
+	{
+	}
+
+	/// Create V8 templates of the class and install recorded bindings
+	void materialize()
+	{
+		if (materialized_)
+		{
+			return;
+		}
+		materialized_ = true;
+
+		v8::HandleScope scope(isolate_);
 		v8::Local<v8::FunctionTemplate> func = v8::FunctionTemplate::New(isolate_,//);
 		//v8::Local<v8::FunctionTemplate> js_func = v8::FunctionTemplate::New(isolate_,
 			[](v8::FunctionCallbackInfo<v8::Value> const& args)
@@ -247,12 +388,22 @@ private:
 
 		// each JavaScript instance has 2 internal fields:
 		//  0 - pointer to a wrapped C++ object
-		//  1 - pointer to the class_singleton
-		func->InstanceTemplate()->SetInternalFieldCount(2);
+		//  1 - wrapper_header with the class type
+		// and for inline values:
+		//  2 - slab ArrayBuffer with the value
+		func->InstanceTemplate()->SetInternalFieldCount(slab_values_
+			? wrapper_header::inline_field_count : wrapper_header::field_count);
 		v8::Local<v8::ObjectTemplate> obj = v8::ObjectTemplate::New(isolate_, func);
 		//obj->SetInternalFieldCount(2);
 		obj_temp_.Reset(isolate_, obj);
 		//class_function_template()->Inherit(js_function_template());
+
+		std::vector<binding> bindings;
+		bindings.swap(bindings_);
+		for (auto& b : bindings)
+		{
+			install(b);
+		}
 	}
 
 	void set_object_on_base(v8::Handle<v8::Object> &obj, T *object_class, object_base_tag)
@@ -269,13 +420,26 @@ private:
 		v8::EscapableHandleScope scope(isolate_);
 		v8::Local<v8::Object> obj = object_template()->NewInstance();
 			//class_function_template()->GetFunction()->NewInstance();
-		obj->SetAlignedPointerInInternalField(0, object);
-		obj->SetAlignedPointerInInternalField(1, this);
+		obj->SetAlignedPointerInInternalField(wrapper_header::object_field, object);
+		obj->SetAlignedPointerInInternalField(wrapper_header::header_field, header());
 
 		set_object_on_base(obj, object, object_type_selector<T>());
 
 		persistent<v8::Object> pobj(isolate_, obj);
-		if (destroy_after)
+		if (destroy_after && destroy_policy_ != destroy_immediate)
+		{
+			// the entry is stable in the objects map until erased by drain_pending()
+			object_entry& entry = class_info::add_object(object, std::move(pobj), true);
+			entry.second.first.SetWeak(&entry,
+				[](v8::WeakCallbackData<v8::Object, object_entry> const& data)
+			{
+				object_entry* entry = data.GetParameter();
+				entry->second.first.Reset();
+				instance(data.GetIsolate()).pending_.push_back(entry->first);
+			});
+			return scope.Escape(obj);
+		}
+		else if (destroy_after)
 		{
 			pobj.SetWeak(object,
 				[](v8::WeakCallbackData<v8::Object, T> const& data)
@@ -304,8 +468,8 @@ private:
 
 	void insert_into_v8_object(T* object, v8::Handle<v8::Context> &obj)
 	{
-		v8::Local<v8::Object>::Cast(obj->Global()->GetPrototype())->SetAlignedPointerInInternalField(0, object);
-		v8::Local<v8::Object>::Cast(obj->Global()->GetPrototype())->SetAlignedPointerInInternalField(1, this);
+		v8::Local<v8::Object>::Cast(obj->Global()->GetPrototype())->SetAlignedPointerInInternalField(wrapper_header::object_field, object);
+		v8::Local<v8::Object>::Cast(obj->Global()->GetPrototype())->SetAlignedPointerInInternalField(wrapper_header::header_field, header());
 
 		set_object_on_base(obj->Global(), object, object_type_selector<T>());
 
@@ -315,8 +479,58 @@ private:
 	}
 
 
+	static void* header()
+	{
+		return wrapper_header::make(class_type(), 0);
+	}
+
+	// Cast object pointer of a wrapper with the class type to T
+	bool cast_wrapped(void*& ptr, type_index type) const
+	{
+		if (type == class_type())
+		{
+			return true;
+		}
+		class_info const* info = class_info::find(isolate_, type);
+		return info && info->cast(ptr, class_type());
+	}
+
+	// Destroy queued objects after each garbage collection, objects
+	// queued for idle time only when they exceed the pending memory limit
+	static void drain_after_gc(v8::Isolate* isolate, v8::GCType, v8::GCCallbackFlags)
+	{
+		class_singleton& self = instance(isolate);
+		if (self.destroy_policy_ != destroy_idle
+			|| self.pending_.size() * object_size<T>::value > self.max_pending_bytes_)
+		{
+			self.drain_pending();
+		}
+	}
+
+	static void delete_object(void* object)
+	{
+		delete static_cast<T*>(object);
+	}
+
+	// Object removed from C++ is not destroyed again by drain_pending()
+	void forget_pending(T* obj)
+	{
+		if (!pending_.empty())
+		{
+			pending_.erase(std::remove(pending_.begin(), pending_.end(), static_cast<void*>(obj)), pending_.end());
+		}
+	}
+
 public:
-	virtual void remove_class_info(){ delete this; };
+	virtual void remove_class_info()
+	{
+		drain_pending();
+		if (drain_after_gc_)
+		{
+			isolate_->RemoveGCEpilogueCallback(&drain_after_gc);
+		}
+		delete this;
+	};
 	static void clear_singletons(v8::Isolate* isolate)
 	{
 		using singleton_instances = std::vector<void*>;
@@ -327,6 +541,7 @@ public:
 		{
 			for (size_t x = 0; x < singletons->size(); x++)
 			{
+				if (!singletons->at(x)) continue;
 				((detail::class_info*)singletons->at(x))->remove_class_info();
 				ref_static::ref_count;
 			}
@@ -349,37 +564,323 @@ public:
 
 		// Get singleton instance from the the list by class_type
 		type_index const my_type = class_type();
-		class_singleton* result;
-		if (my_type < singletons->size())
+		if (my_type >= singletons->size())
 		{
-			result = static_cast<class_singleton*>((*singletons)[my_type]);
+			// classes may be used in isolates in different order,
+			// the list is indexed by class_type with gaps for unused classes
+			singletons->resize(my_type + 1, nullptr);
 		}
-		else
+		class_singleton* result = static_cast<class_singleton*>((*singletons)[my_type]);
+		if (!result)
 		{
 			// No singleton instance, create and add it
 			result = new class_singleton(isolate, my_type);
-			singletons->emplace_back(result);
+			(*singletons)[my_type] = result;
 		}
 		return *result;
 	}
 
 	v8::Isolate* isolate() { return isolate_; }
 
+	/// Templates are created on first access
 	v8::Local<v8::FunctionTemplate> class_function_template()
 	{
+		materialize();
 		return to_local(isolate_, func_);
 	}
 
 	v8::Local<v8::FunctionTemplate> js_function_template()
 	{
+		materialize();
 		return to_local(isolate_, js_func_.IsEmpty()? func_ : js_func_);
 	}
 
 	v8::Local<v8::ObjectTemplate> object_template()
 	{
+		materialize();
 		return to_local(isolate_, obj_temp_);
 	}
 
+	bool materialized() const { return materialized_; }
+
+	/// Binding of the class templates recorded until materialize():
+	/// install function for the binding kind, property name and
+	/// the bound data, a V8 value or raw C++ data. The External
+	/// for C++ data is created only when the binding is installed.
+	struct binding
+	{
+		using install_function = void (*)(class_singleton& singleton, binding const& b, v8::Local<v8::Value> data);
+		using external_function = v8::Local<v8::Value> (*)(v8::Isolate* isolate, void* data);
+		using delete_function = void (*)(void* data);
+
+		install_function install;
+		std::string name;
+		persistent<v8::Value> value;
+		void* data;                 // C++ data, pointer size data is stored in place
+		external_function external; // creates External of C++ data, null for V8 value
+		delete_function deleter;    // deletes C++ data not passed to the External
+		v8::PropertyAttribute attrs;
+		return_empty empty_return;
+
+		binding(install_function install, std::string name, persistent<v8::Value>&& value,
+			v8::PropertyAttribute attrs, return_empty empty_return)
+			: install(install)
+			, name(std::move(name))
+			, value(std::move(value))
+			, data(nullptr)
+			, external(nullptr)
+			, deleter(nullptr)
+			, attrs(attrs)
+			, empty_return(empty_return)
+		{
+		}
+
+		template<typename Data>
+		binding(install_function install, std::string name, Data const& data,
+			v8::PropertyAttribute attrs, return_empty empty_return)
+			: install(install)
+			, name(std::move(name))
+			, attrs(attrs)
+			, empty_return(empty_return)
+		{
+			set_data(data);
+		}
+
+		binding(binding&& src)
+			: install(src.install)
+			, name(std::move(src.name))
+			, value(std::move(src.value))
+			, data(src.data)
+			, external(src.external)
+			, deleter(src.deleter)
+			, attrs(src.attrs)
+			, empty_return(src.empty_return)
+		{
+			src.deleter = nullptr;
+		}
+
+		binding& operator=(binding&& src)
+		{
+			if (this != &src)
+			{
+				if (deleter)
+				{
+					deleter(data);
+				}
+				install = src.install;
+				name = std::move(src.name);
+				value = std::move(src.value);
+				data = src.data;
+				external = src.external;
+				deleter = src.deleter;
+				attrs = src.attrs;
+				empty_return = src.empty_return;
+				src.deleter = nullptr;
+			}
+			return *this;
+		}
+
+		~binding()
+		{
+			if (deleter)
+			{
+				deleter(data);
+			}
+		}
+
+		binding(binding const&) = delete;
+		binding& operator=(binding const&) = delete;
+
+		/// V8 value of the binding, C++ data is passed to a new External
+		v8::Local<v8::Value> make_data(v8::Isolate* isolate)
+		{
+			if (!external)
+			{
+				return to_local(isolate, value);
+			}
+			deleter = nullptr;
+			return external(isolate, data);
+		}
+
+	private:
+		template<typename Data>
+		typename std::enable_if<is_pointer_cast_allowed<Data>::value>::type set_data(Data const& src)
+		{
+			data = pointer_cast<Data>(src);
+			external = &external_in_place;
+			deleter = nullptr;
+		}
+
+		template<typename Data>
+		typename std::enable_if<!is_pointer_cast_allowed<Data>::value>::type set_data(Data const& src)
+		{
+			data = new Data(src);
+			external = &external_owned<Data>;
+			deleter = &delete_object_callback<Data>;
+		}
+
+		static v8::Local<v8::Value> external_in_place(v8::Isolate* isolate, void* data)
+		{
+			return v8::External::New(isolate, data);
+		}
+
+		template<typename Data>
+		static v8::Local<v8::Value> external_owned(v8::Isolate* isolate, void* data)
+		{
+			return external_info::emplace_data(isolate, data, &delete_object_callback<Data>);
+		}
+	};
+
+	/// Install a binding into the class templates, now if they exist
+	/// or on materialize() otherwise. Bindings are installed in the order they were added.
+	void add_binding(typename binding::install_function install, char const* name,
+		v8::Handle<v8::Value> value, v8::PropertyAttribute attrs = v8::None, return_empty empty_return = NONE)
+	{
+		add_binding(binding(install, name, persistent<v8::Value>(isolate_, value), attrs, empty_return));
+	}
+
+	/// Install a binding with a copy of C++ data, the External for the data
+	/// is created on install and named for the profiler with the binding name
+	template<typename Data>
+	void add_data_binding(typename binding::install_function install, char const* name,
+		Data const& data, v8::PropertyAttribute attrs = v8::None, return_empty empty_return = NONE)
+	{
+		add_binding(binding(install, name, data, attrs, empty_return));
+	}
+
+	/// Number of bindings waiting for materialize()
+	size_t pending_bindings() const { return bindings_.size(); }
+
+	/// Number of named interceptor keys in the hit counting table
+	size_t counted_keys() const { return key_hits_.size(); }
+
+	void set_has_handler() { has_handler_ = true; }
+
+	/// Promote keys of the named interceptor accessed threshold times
+	/// and reported as stable to own accessors of the objects
+	void set_key_promotion(bool (*stable)(string_view), uint32_t threshold)
+	{
+		promote_stable_ = stable;
+		promote_threshold_ = std::max<uint32_t>(threshold, 1);
+		key_hits_.clear();
+		key_candidates_ = 0;
+	}
+
+	/// Count a named interceptor hit, true if the key should be promoted.
+	/// Keys are found by identity hash and compared as V8 strings to avoid
+	/// string conversion on each hit, the stable check runs once per key
+	/// when it reaches the threshold. Only promoted keys and at most
+	/// max_key_candidates keys being counted are kept, unstable keys
+	/// are forgotten and counted again from zero.
+	bool count_key_hit(v8::Local<v8::String> name)
+	{
+		if (!promote_stable_)
+		{
+			return false;
+		}
+
+		auto it = find_key(name);
+		if (it == key_hits_.end())
+		{
+			if (key_candidates_ >= max_key_candidates)
+			{
+				drop_key_candidates();
+			}
+			it = key_hits_.emplace(name->GetIdentityHash(), std::make_pair(persistent<v8::String>(isolate_, name), 0u));
+			++key_candidates_;
+		}
+
+		uint32_t& hits = it->second.second;
+		if (hits == key_promoted)
+		{
+			return true;
+		}
+		if (++hits < promote_threshold_)
+		{
+			return false;
+		}
+
+		--key_candidates_;
+		std::string const key = v8pp::from_v8<std::string>(isolate_, name);
+		if (!promote_stable_(string_view(key.data(), key.size())))
+		{
+			key_hits_.erase(it);
+			return false;
+		}
+		hits = key_promoted;
+		promoted_keys_.push_back(key);
+		return true;
+	}
+
+	using key_hits_map = std::unordered_multimap<int, std::pair<persistent<v8::String>, uint32_t>>;
+
+	// Hit counter entry of the key, identity hashes of different keys may collide
+	key_hits_map::iterator find_key(v8::Local<v8::String> name)
+	{
+		auto range = key_hits_.equal_range(name->GetIdentityHash());
+		for (auto it = range.first; it != range.second; ++it)
+		{
+			if (name->StrictEquals(to_local(isolate_, it->second.first)))
+			{
+				return it;
+			}
+		}
+		return key_hits_.end();
+	}
+
+	// Forget counted keys that are not promoted yet, cold keys don't grow the table
+	void drop_key_candidates()
+	{
+		for (auto it = key_hits_.begin(); it != key_hits_.end(); )
+		{
+			if (it->second.second == key_promoted)
+			{
+				++it;
+			}
+			else
+			{
+				it = key_hits_.erase(it);
+			}
+		}
+		key_candidates_ = 0;
+	}
+
+	/// Remove promoted accessors from the object,
+	/// its keys are handled by the interceptor again
+	void demote_keys(v8::Local<v8::Object> obj)
+	{
+		for (std::string const& key : promoted_keys_)
+		{
+			obj->Delete(v8pp::to_v8(isolate_, key));
+		}
+	}
+
+	/// Remove promoted accessors from all objects of the class and restart hit counting
+	void reset_promoted_keys()
+	{
+		v8::HandleScope scope(isolate_);
+		for (auto it = objects_begin(); it != objects_end(); ++it)
+		{
+			demote_keys(to_local(isolate_, it->second.first));
+		}
+		promoted_keys_.clear();
+		key_hits_.clear();
+		key_candidates_ = 0;
+	}
+
+	bool set_class_name(char const* name)
+	{
+		if (class_name_set_)
+		{
+			return false;
+		}
+		class_name_set_ = true;
+
+		V8PP_PROFILE_GROUP(isolate_, this, name);
+		add_binding(&install_class_name, name, v8::Handle<v8::Value>());
+		return true;
+	}
+
 	template<typename ...Args>
 	void ctor()
 	{
@@ -389,6 +890,74 @@ public:
 			return call_from_v8(static_cast<ctor_type>(&factory<T>::create), args);
 		};
 		//class_function_template()->Inherit(js_function_template());
+		value_ctor<Args...>(std::integral_constant<bool,
+			is_inline_value<T>::value && std::is_constructible<T, Args...>::value>());
+	}
+
+	template<typename ...Args>
+	static T make_value(v8::Isolate*, Args... args)
+	{
+		return T(std::forward<Args>(args)...);
+	}
+
+	template<typename ...Args>
+	void value_ctor(std::true_type)
+	{
+		value_ctor_ = [](v8::FunctionCallbackInfo<v8::Value> const& args)
+		{
+			using ctor_type = T (*)(v8::Isolate* isolate, Args...);
+			return instance(args.GetIsolate()).wrap_value(
+				call_from_v8(static_cast<ctor_type>(&make_value<Args...>), args));
+		};
+	}
+
+	template<typename ...Args>
+	void value_ctor(std::false_type)
+	{
+		value_ctor_ = nullptr;
+	}
+
+	/// Store values inline in slabs of values_per_slab, 0 to disable.
+	/// Should be set before the class templates are created
+	void set_inline_values(size_t values_per_slab)
+	{
+		if (materialized_)
+		{
+			throw std::runtime_error("inline values should be set before the class is used");
+		}
+		slab_values_ = values_per_slab;
+	}
+
+	bool inline_values() const { return slab_values_ != 0; }
+
+	/// Copy the value into a slot of the current slab and wrap the slot.
+	/// There is no C++ object to destroy, the wrapper is not tracked
+	/// and keeps the slab alive in own internal field
+	v8::Handle<v8::Object> wrap_value(T const& value)
+	{
+		size_t const align = std::alignment_of<T>::value < 2 ? 2 : std::alignment_of<T>::value;
+		size_t const slot_size = (sizeof(T) + align - 1) / align * align;
+
+		v8::EscapableHandleScope scope(isolate_);
+		if (slab_.IsEmpty() || slab_used_ + slot_size > slab_size_)
+		{
+			// the full slab is released to GC with its last wrapper
+			slab_size_ = slab_values_ * slot_size;
+			v8::Local<v8::ArrayBuffer> slab = v8::ArrayBuffer::New(isolate_, slab_size_);
+			slab_.Reset(isolate_, slab);
+			slab_data_ = static_cast<char*>(slab->GetContents().Data());
+			slab_used_ = 0;
+		}
+		void* storage = slab_data_ + slab_used_;
+		slab_used_ += slot_size;
+		std::memcpy(storage, &value, sizeof(T));
+
+		v8::Local<v8::Object> obj = object_template()->NewInstance();
+		obj->SetAlignedPointerInInternalField(wrapper_header::object_field, storage);
+		obj->SetAlignedPointerInInternalField(wrapper_header::header_field,
+			wrapper_header::make(class_type(), wrapper_header::inline_value));
+		obj->SetInternalField(wrapper_header::slab_field, to_local(isolate_, slab_));
+		return scope.Escape(obj);
 	}
 
 	template<typename U>
@@ -399,7 +968,8 @@ public:
 			{
 				return static_cast<U*>(static_cast<T*>(ptr));
 			});
-		js_function_template()->Inherit(base->class_function_template());
+		v8::HandleScope scope(isolate_);
+		add_binding(&install_base<U>, "", v8::External::New(isolate_, base));
 	}
 
 	v8::Handle<v8::Object> wrap_external_object(T* object)
@@ -424,6 +994,10 @@ public:
 
 	v8::Handle<v8::Object> wrap_object(v8::FunctionCallbackInfo<v8::Value> const& args)
 	{
+		if (slab_values_ && value_ctor_)
+		{
+			return value_ctor_(args);
+		}
 		return ctor_? wrap_object(ctor_(args)) : throw std::runtime_error("create is not allowed");
 	}
 
@@ -437,11 +1011,10 @@ public:
 		while (value->IsObject())
 		{
 			v8::Handle<v8::Object> obj = value->ToObject();
-			if (obj->InternalFieldCount() == 2)
+			if (void const* header = wrapper_header::get(obj))
 			{
-				void* ptr = obj->GetAlignedPointerFromInternalField(0);
-				class_info* info = static_cast<class_info*>(obj->GetAlignedPointerFromInternalField(1));
-				if (info && info->cast(ptr, class_type()))
+				void* ptr = obj->GetAlignedPointerFromInternalField(wrapper_header::object_field);
+				if (cast_wrapped(ptr, wrapper_header::type(header)))
 				{
 					return static_cast<T*>(ptr);
 				}
@@ -451,6 +1024,35 @@ public:
 		return nullptr;
 	}
 
+	/// Unwrap `this` object of a callback. Objects of exactly T class
+	/// are unwrapped without a handle scope and prototype chain walk
+	T* unwrap_this(v8::Local<v8::Object> obj)
+	{
+		void const* header = wrapper_header::get(obj);
+		if (header && wrapper_header::type(header) == class_type())
+		{
+			return static_cast<T*>(obj->GetAlignedPointerFromInternalField(wrapper_header::object_field));
+		}
+		return unwrap_object(obj);
+	}
+
+	/// Unwrap a receiver checked by the class signature, i.e. a wrapper
+	/// of T or a derived class, without the wrapper validation
+	T* unwrap_trusted(v8::Local<v8::Object> obj)
+	{
+		void* ptr = obj->GetAlignedPointerFromInternalField(wrapper_header::object_field);
+		void const* header = obj->GetAlignedPointerFromInternalField(wrapper_header::header_field);
+		return cast_wrapped(ptr, wrapper_header::type(header)) ? static_cast<T*>(ptr) : nullptr;
+	}
+
+	/// Receiver check for prototype methods, empty if disabled
+	v8::Local<v8::Signature> signature()
+	{
+		return receiver_check_ ? v8::Signature::New(isolate_, class_function_template()) : v8::Local<v8::Signature>();
+	}
+
+	void set_receiver_check(bool check) { receiver_check_ = check; }
+
 	bool get_object_from_base(v8::Handle<v8::Object> &obj, const T *object_class, object_base_tag)
 	{
 		if (object_class == NULL)
@@ -473,18 +1075,103 @@ public:
 		return v8_object;
 	}
 
-	void destroy_objects()
+	/// Set destroy policy for objects wrapped after the call.
+	/// Objects queued with the previous policy are destroyed now.
+	void set_destroy_policy(destroy_policy policy, size_t max_pending_bytes)
 	{
-		class_info::remove_objects(isolate_, &factory<T>::destroy);
-	}
+		if (policy == destroy_background && !thread_safe_destructible<T>::value)
+		{
+			throw std::runtime_error("destroy_background policy requires thread_safe_destructible class");
+		}
 
-	void destroy_object(T* obj)
-	{
-		class_info::remove_object(isolate_, obj, &factory<T>::destroy);
+		drain_pending();
+		max_pending_bytes_ = max_pending_bytes;
+		// objects queued by weak callbacks of earlier wrapped objects
+		// are drained after GC even if the policy is changed back
+		if (policy != destroy_immediate && !drain_after_gc_)
+		{
+			isolate_->AddGCEpilogueCallback(&drain_after_gc);
+			drain_after_gc_ = true;
+		}
+		destroy_policy_ = policy;
 	}
 
-	void remove_stored_object(T* obj)
-	{
+	destroy_policy get_destroy_policy() const { return destroy_policy_; }
+
+	/// Number of objects queued by weak callbacks
+	size_t pending_objects() const { return pending_.size(); }
+
+	/// Destroy objects queued by weak callbacks and erase them
+	/// from the objects map in one sweep
+	void drain_pending()
+	{
+		if (pending_.empty())
+		{
+			return;
+		}
+
+		std::vector<void*> objects;
+		objects.swap(pending_);
+		for (void* object : objects)
+		{
+			class_info::erase_object(object);
+		}
+
+		if (destroy_policy_ == destroy_background)
+		{
+			// factory<T>::destroy accounting for the deleted objects
+			isolate_->AdjustAmountOfExternalAllocatedMemory(
+				-static_cast<int64_t>(object_size<T>::value * objects.size()));
+			background_deleter::instance().enqueue(&delete_object, objects);
+		}
+		else
+		{
+			for (void* object : objects)
+			{
+				factory<T>::destroy(isolate_, static_cast<T*>(object));
+			}
+		}
+	}
+
+	virtual bool drain_idle(std::chrono::steady_clock::time_point deadline)
+	{
+		if (destroy_policy_ != destroy_idle)
+		{
+			drain_pending();
+			return true;
+		}
+
+		// check the clock every few objects, destructors are usually short
+		size_t count = 0;
+		while (!pending_.empty())
+		{
+			void* object = pending_.back();
+			pending_.pop_back();
+			class_info::erase_object(object);
+			factory<T>::destroy(isolate_, static_cast<T*>(object));
+			if (++count % 16 == 0 && std::chrono::steady_clock::now() >= deadline)
+			{
+				break;
+			}
+		}
+		return pending_.empty();
+	}
+
+	void destroy_objects()
+	{
+		drain_pending();
+		class_info::remove_objects(isolate_, &factory<T>::destroy);
+	}
+
+	void destroy_object(T* obj)
+	{
+		forget_pending(obj);
+		class_info::remove_object(isolate_, obj, &factory<T>::destroy);
+	}
+
+	void remove_stored_object(T* obj)
+	{
+		forget_pending(obj);
 		class_info::remove_object<T>(isolate_, obj, nullptr);
 	}
 
@@ -502,6 +1189,7 @@ public:
 		func_.Reset();
 		js_func_.Reset();
 		obj_temp_.Reset();
+		slab_.Reset();
 		class_info::release_v8_objects();
 	}
 	void auto_import(bool auto_import){ auto_imp_ = auto_import; };
@@ -510,14 +1198,94 @@ public:
 	void auto_reference(bool auto_ref){ auto_ref_ = auto_ref; };
 	bool auto_reference(){ return auto_ref_; };
 private:
+	void add_binding(binding&& b)
+	{
+		if (materialized_)
+		{
+			install(b);
+		}
+		else
+		{
+			bindings_.emplace_back(std::move(b));
+		}
+	}
+
+	void install(binding& b)
+	{
+		v8::HandleScope scope(isolate_);
+		bool const external = b.external != nullptr;
+		v8::Local<v8::Value> data = b.make_data(isolate_);
+		if (external)
+		{
+			V8PP_PROFILE_NAME(isolate_, data, this, b.name.c_str());
+		}
+		b.install(*this, b, data);
+	}
+
+	static void install_class_name(class_singleton& singleton, binding const& b, v8::Local<v8::Value> /*data*/)
+	{
+		v8::Isolate* isolate = singleton.isolate_;
+		singleton.class_function_template()->SetClassName(v8pp::to_v8(isolate, b.name));
+		if (!singleton.has_handler_)
+		{
+			v8pp::debug::set_debug_handler(singleton.js_function_template()->PrototypeTemplate(), b.name.c_str(), isolate);
+			v8pp::debug::set_debug_handler(singleton.class_function_template()->PrototypeTemplate(), b.name.c_str(), isolate);
+		}
+	}
+
+	template<typename U>
+	static void install_base(class_singleton& singleton, binding const& /*b*/, v8::Local<v8::Value> data)
+	{
+		class_singleton<U>* base = static_cast<class_singleton<U>*>(data.As<v8::External>()->Value());
+		singleton.js_function_template()->Inherit(base->class_function_template());
+	}
+
 	v8::Isolate* isolate_;
 	std::function<T* (v8::FunctionCallbackInfo<v8::Value> const& args)> ctor_;
+	v8::Handle<v8::Object> (*value_ctor_)(v8::FunctionCallbackInfo<v8::Value> const& args);
 	bool auto_ref_ = false;
 	bool auto_imp_ = false;
 
 	v8::UniquePersistent<v8::FunctionTemplate> func_;
 	v8::UniquePersistent<v8::FunctionTemplate> js_func_;
 	v8::UniquePersistent<v8::ObjectTemplate> obj_temp_;
+
+	bool materialized_;
+	bool has_handler_;
+	bool class_name_set_;
+	std::vector<binding> bindings_;
+
+	static uint32_t const key_promoted = ~0u;
+	static size_t const max_key_candidates = 256;
+
+	bool (*promote_stable_)(string_view);
+	uint32_t promote_threshold_;
+	key_hits_map key_hits_;
+	size_t key_candidates_;
+	std::vector<std::string> promoted_keys_;
+
+	destroy_policy destroy_policy_;
+	bool drain_after_gc_;
+	size_t max_pending_bytes_;
+	std::vector<void*> pending_;
+	bool receiver_check_;
+
+	// inline values
+	size_t slab_values_;
+	v8::UniquePersistent<v8::ArrayBuffer> slab_;
+	char* slab_data_;
+	size_t slab_used_;
+	size_t slab_size_;
+};
+
+/// Lazy property factory for JavaScript constructor function of class T
+template<typename T>
+struct lazy_class_function
+{
+	static v8::Local<v8::Value> create(v8::Isolate* isolate, v8::Local<v8::String>, v8::Local<v8::Value>)
+	{
+		return class_singleton<T>::instance(isolate).js_function_template()->GetFunction();
+	}
 };
 
 } // namespace detail
@@ -551,21 +1319,22 @@ public:
 		return *this;
 	}
 
+	/// Set V8 value in the class prototype
 	class_& set(char const* name, v8::Local<v8::Value> value)
 	{
-		class_singleton_.class_function_template()->PrototypeTemplate()->Set(isolate(), name, value);
+		v8::HandleScope scope(isolate());
+		class_singleton_.add_binding(&install_value<class_prototype>, name, value);
 		return *this;
 	}
 
-	///
-	/// Probably can't do this unless the context is created. So cant be set for the global object instance until
-	///	after the context is created.
-	///
-	template<typename T>
-	class_& set(char const* name, class_<T>& cl)
+	/// Set class U constructor in the class prototype,
+	/// the constructor function is created on first access
+	template<typename U>
+	class_& set(char const* name, class_<U>& cl)
 	{
 		cl.set_class_name(name, isolate());
-		return set(name, cl.js_function_template()->GetFunction());
+		class_singleton_.add_binding(&install_class_function<U>, name, v8::Handle<v8::Value>());
+		return *this;
 	}
 
 	/// Set C++ class member function
@@ -574,10 +1343,8 @@ public:
 		std::is_member_function_pointer<Method>::value, class_&>::type
 		set(char const *name, Method mem_func, bool dont_enum = false, return_empty empty_return = NONE)
 	{
-		v8::PropertyAttribute const prop_attrs = v8::PropertyAttribute((dont_enum ? v8::DontEnum : v8::None));
-		class_singleton_.class_function_template()->PrototypeTemplate()->Set(
-			v8pp::to_v8(isolate(), name), wrap_function_template(isolate(), mem_func, empty_return), prop_attrs);
-		return *this;
+		return add_binding(&install_method<Method>, name, mem_func,
+			v8::PropertyAttribute(dont_enum ? v8::DontEnum : v8::None), empty_return);
 	}
 
 	/// Set static class function
@@ -586,10 +1353,8 @@ public:
 		detail::is_function_pointer<Function>::value, class_&>::type
 		set(char const *name, Function func, bool dont_enum = false)
 	{
-		v8::PropertyAttribute const prop_attrs = v8::PropertyAttribute((dont_enum ? v8::DontEnum : v8::None));
-		class_singleton_.js_function_template()->PrototypeTemplate()->Set(v8pp::to_v8(isolate(), name),
-			wrap_function_template(isolate(), func), prop_attrs);
-		return *this;
+		return add_binding(&install_function<Function>, name, func,
+			v8::PropertyAttribute(dont_enum ? v8::DontEnum : v8::None));
 	}
 
 	/// Set class member data
@@ -597,22 +1362,9 @@ public:
 	typename std::enable_if<
 		std::is_member_object_pointer<Attribute>::value, class_&>::type
 		set(char const *name, Attribute attribute, bool readonly = false, bool dont_enum = false)
-	{ 
-		v8::HandleScope scope(isolate());
-
-		v8::AccessorGetterCallback getter = &member_get<Attribute>;
-		v8::AccessorSetterCallback setter = &member_set<Attribute>;
-		if (readonly)
-		{
-			setter = nullptr;
-		}
-
-		v8::Handle<v8::Value> data = detail::set_external_data(isolate(), attribute);
-		v8::PropertyAttribute const prop_attrs = v8::PropertyAttribute(v8::DontDelete | (setter ? 0 : v8::ReadOnly) | (dont_enum ? v8::DontEnum : v8::None));
-
-		class_singleton_.class_function_template()->PrototypeTemplate()->SetAccessor(
-			v8pp::to_v8(isolate(), name), getter, setter, data, v8::DEFAULT, prop_attrs);
-		return *this;
+	{
+		return add_binding(&install_accessor<&member_get<Attribute>, &member_set<Attribute>>,
+			name, attribute, accessor_attrs(readonly, dont_enum));
 	}
 
 	/// Set class attribute with getter and setter
@@ -621,21 +1373,9 @@ public:
 		&& std::is_member_function_pointer<SetMethod>::value, class_&>::type
 		set(char const *name, property_<GetMethod, SetMethod> prop, bool dont_enum = false)
 	{
-		v8::HandleScope scope(isolate());
-
-		v8::AccessorGetterCallback getter = property_<GetMethod, SetMethod>::get;
-		v8::AccessorSetterCallback setter = property_<GetMethod, SetMethod>::set;
-		if (property_<GetMethod, SetMethod>::is_readonly)
-		{
-			setter = nullptr;
-		}
-
-		v8::Handle<v8::Value> data = detail::set_external_data(isolate(), prop);
-		v8::PropertyAttribute const prop_attrs = v8::PropertyAttribute(v8::DontDelete | (setter ? 0 : v8::ReadOnly) | (dont_enum ? v8::DontEnum : v8::None));
-
-		class_singleton_.class_function_template()->PrototypeTemplate()->SetAccessor(v8pp::to_v8(isolate(), name),
-			getter, setter, data, v8::DEFAULT, prop_attrs);
-		return *this;
+		using property_type = property_<GetMethod, SetMethod>;
+		return add_binding(&install_accessor<&property_type::get, &property_type::set>,
+			name, prop, accessor_attrs(property_type::is_readonly, dont_enum));
 	}
 
 	template<typename GetMethod, typename SetMethod>
@@ -643,26 +1383,8 @@ public:
 		&& std::is_member_function_pointer<SetMethod>::value, class_&>::type
 		set_named_interceptor(property_<GetMethod, SetMethod> prop)
 	{
-		v8::HandleScope scope(isolate());
-
-		v8::AccessorGetterCallback getter = property_<GetMethod, SetMethod>::get;
-		v8::AccessorSetterCallback setter = property_<GetMethod, SetMethod>::set;
-		if (property_<GetMethod, SetMethod>::is_readonly)
-		{
-			setter = nullptr;
-		}
-
-		v8::Handle<v8::Value> data = detail::set_external_data(isolate(), prop);
-
-		v8::NamedPropertyHandlerConfiguration config;
-		config.getter = (v8::GenericNamedPropertyGetterCallback)getter;
-		config.setter = (v8::GenericNamedPropertySetterCallback)setter;
-		config.data = data;
-		config.flags = v8::PropertyHandlerFlags::kNonMasking;
-
-		class_singleton_.class_function_template()->PrototypeTemplate()->SetHandler(config);
-		has_handler = true;
-		return *this;
+		class_singleton_.set_has_handler();
+		return add_binding(&install_named_property<property_<GetMethod, SetMethod>>, "[named]", prop);
 	}
 
 	template<typename GetMethod, typename SetMethod>
@@ -670,156 +1392,91 @@ public:
 		&& std::is_member_function_pointer<SetMethod>::value, class_&>::type
 		set_index_interceptor(property_<GetMethod, SetMethod> prop)
 	{
-		v8::HandleScope scope(isolate());
-
-		v8::IndexedPropertyGetterCallback getter = (v8::IndexedPropertyGetterCallback)property_<GetMethod, SetMethod>::get;
-		v8::IndexedPropertySetterCallback setter = (v8::IndexedPropertySetterCallback)property_<GetMethod, SetMethod>::set;
-		if (property_<GetMethod, SetMethod>::is_readonly)
-		{
-			setter = nullptr;
-		}
-
-		v8::Handle<v8::Value> data = detail::set_external_data(isolate(), prop);
-
-		v8::IndexedPropertyHandlerConfiguration config;
-		config.getter = getter;
-		config.setter = setter;
-		config.data = data;
-		config.flags = v8::PropertyHandlerFlags::kNonMasking;
-
-		class_singleton_.class_function_template()->PrototypeTemplate()->SetHandler(config);
-		has_handler = true;
-		return *this;
+		class_singleton_.set_has_handler();
+		return add_binding(&install_indexed_property<property_<GetMethod, SetMethod>, void>, "[indexed]", prop);
 	}
 
 	template<typename GetMethod, typename SetMethod, typename GetMethod2>
 	typename std::enable_if<std::is_member_function_pointer<GetMethod>::value
 		&& std::is_member_function_pointer<SetMethod>::value
 		&& std::is_member_function_pointer<GetMethod2>::value, class_&>::type
-		set_index_interceptor(property_<GetMethod, SetMethod> prop, property_<GetMethod2, GetMethod2> prop2)
+		set_index_interceptor(property_<GetMethod, SetMethod> prop, property_<GetMethod2, GetMethod2> /*prop2*/)
 	{
-		v8::HandleScope scope(isolate());
-
-		v8::IndexedPropertyGetterCallback getter = (v8::IndexedPropertyGetterCallback)property_<GetMethod, SetMethod>::get;
-		v8::IndexedPropertySetterCallback setter = (v8::IndexedPropertySetterCallback)property_<GetMethod, SetMethod>::set;
-		v8::IndexedPropertyQueryCallback queryer = (v8::IndexedPropertyQueryCallback)property_<GetMethod2, GetMethod2>::get;
-		if (property_<GetMethod, SetMethod>::is_readonly)
-		{
-			setter = nullptr;
-		}
-
-		v8::Handle<v8::Value> data = detail::set_external_data(isolate(), prop);
-
-		v8::IndexedPropertyHandlerConfiguration config;
-		config.getter = getter;
-		config.setter = setter;
-		config.query = queryer;
-		//config.enumerator
-		config.data = data;
-		config.flags = v8::PropertyHandlerFlags::kNonMasking;
-
-		class_singleton_.class_function_template()->PrototypeTemplate()->SetHandler(config);
-		//class_singleton_.class_function_template()->PrototypeTemplate()->
-		has_handler = true;
-		return *this;
+		class_singleton_.set_has_handler();
+		return add_binding(&install_indexed_property<property_<GetMethod, SetMethod>,
+			property_<GetMethod2, GetMethod2>>, "[indexed]", prop);
 	}
 
-	template<typename Get, typename Set, typename Enum, typename Query, typename Del>
-	class_& set_index_interceptor(interceptor_data<Get, Set, Enum, Query, Del> indexer)
+	/// Indexed access obj[i] to contiguous storage of the object:
+	/// element i of (obj.*data)() for i < (obj.*size)(). Arithmetic elements
+	/// are read without handle allocation. Elements are read-only
+	/// for read_only or data() returning a pointer to const.
+	template<typename Data, typename Size>
+	class_& set_indexed_storage(Data data, Size size, bool read_only = false)
 	{
-		v8::HandleScope scope(isolate());
+		using storage_type = detail::indexed_storage<Data, Size>;
 
-		v8::IndexedPropertyGetterCallback getter = indexed_interceptor<Get, Set, Enum, Query, Del>::propertyGetter;
-		v8::IndexedPropertySetterCallback setter = indexed_interceptor<Get, Set, Enum, Query, Del>::propertySetter;
-		v8::IndexedPropertyEnumeratorCallback enumer = indexed_interceptor<Get, Set, Enum, Query, Del>::propertyEnumerator;
-		v8::IndexedPropertyQueryCallback query = indexed_interceptor<Get, Set, Enum, Query, Del>::propertyQuery;
-		v8::IndexedPropertyDeleterCallback del = indexed_interceptor<Get, Set, Enum, Query, Del>::propertyDel;
+		storage_type storage;
+		storage.data = data;
+		storage.size = size;
+		storage.read_only = read_only;
 
-		v8::Handle<v8::Value> data = detail::set_external_data(isolate(), indexer);
+		class_singleton_.set_has_handler();
+		return add_binding(&install_indexed_storage<storage_type>, "[indexed]", storage);
+	}
 
-		v8::IndexedPropertyHandlerConfiguration config;
-		if (indexer.using_get)
-			config.getter = getter;
-		if (indexer.using_set)
-			config.setter = setter;
-		if (indexer.using_enum)
-			config.enumerator = enumer;
-		if (indexer.using_query)
-			config.query = query;
-		if (indexer.using_del)
-			config.deleter = del;
+	/// Read-only property with a typed array view on arithmetic elements
+	/// of the object storage (obj.*data)() with (obj.*size)() length.
+	/// The view shares memory with the storage and keeps the object wrapper
+	/// alive. One view per object is cached, a new view is created on access
+	/// after the storage is reallocated; an old view should not be used then.
+	template<typename Data, typename Size>
+	class_& set_typed_array(char const* name, Data data, Size size)
+	{
+		using storage_type = detail::indexed_storage<Data, Size>;
 
-		config.data = data;
-		config.flags = v8::PropertyHandlerFlags::kNonMasking;
+		storage_type storage;
+		storage.data = data;
+		storage.size = size;
+		storage.read_only = false;
 
-		class_singleton_.object_template()->SetHandler(config);
+		return add_binding(&install_getter<&storage_type::get_view>, name, storage,
+			v8::PropertyAttribute(v8::DontDelete | v8::ReadOnly));
+	}
 
-		has_handler = true;
-		return *this;
+	template<typename Get, typename Set, typename Enum, typename Query, typename Del>
+	class_& set_index_interceptor(interceptor_data<Get, Set, Enum, Query, Del> indexer)
+	{
+		class_singleton_.set_has_handler();
+		return add_binding(&install_indexed_interceptor<Get, Set, Enum, Query, Del>, "[indexed]", indexer);
 	}
 
 	template<typename Get, typename Set, typename Enum, typename Query, typename Del>
 	class_& set_named_interceptor(interceptor_data<Get, Set, Enum, Query, Del> indexer)
 	{
-		
-		v8::NamedPropertyGetterCallback getter = indexed_interceptor<Get, Set, Enum, Query, Del>::propertyGetter;
-		v8::NamedPropertySetterCallback setter = indexed_interceptor<Get, Set, Enum, Query, Del>::propertySetter;
-		v8::NamedPropertyEnumeratorCallback enumer = indexed_interceptor<Get, Set, Enum, Query, Del>::propertyEnumerator;
-		v8::NamedPropertyQueryCallback query = indexed_interceptor<Get, Set, Enum, Query, Del>::propertyQuery;
-		v8::NamedPropertyDeleterCallback del = indexed_interceptor<Get, Set, Enum, Query, Del>::propertyDel;
-
-		v8::Handle<v8::Value> data = detail::set_external_data(isolate(), indexer);
-
-		v8::NamedPropertyHandlerConfiguration config;
-		if (indexer.using_get)
-			config.getter = (v8::GenericNamedPropertyGetterCallback)getter;
-		if (indexer.using_set)
-			config.setter = (v8::GenericNamedPropertySetterCallback)setter;
-		if (indexer.using_enum)
-			config.enumerator = (v8::GenericNamedPropertyEnumeratorCallback)enumer;
-		if (indexer.using_query)
-			config.query = (v8::GenericNamedPropertyQueryCallback)query;
-		if (indexer.using_del)
-			config.deleter = (v8::GenericNamedPropertyDeleterCallback)del;
-
-		config.data = data;
-		config.flags = v8::PropertyHandlerFlags::kNonMasking;
+		class_singleton_.set_has_handler();
+		return add_binding(&install_named_interceptor<false,
+			Get, Set, Enum, Query, Del>, "[named]", indexer);
+	}
 
-		class_singleton_.object_template()->SetHandler(config);
-		has_handler = true;
+	/// Promote hot keys of the named interceptor to own accessors of the objects.
+	/// A key read through the interceptor threshold times is checked once
+	/// with stable(key), a stable key gets an accessor calling the interceptor
+	/// getter and setter on the object, so V8 inline caches can specialize it.
+	/// Call reset_promoted_keys() when the set of stable keys changes.
+	/// Only keys of interceptors with a `void set(key, value)` setter are promoted.
+	class_& promote_hot_keys(bool (*stable)(string_view), uint32_t threshold = 16)
+	{
+		class_singleton_.set_key_promotion(stable, threshold);
 		return *this;
 	}
 
 	template<typename Get, typename Set, typename Enum, typename Query, typename Del>
 	class_& set_named_prototype_interceptor(interceptor_data<Get, Set, Enum, Query, Del> indexer)
 	{
-
-		v8::NamedPropertyGetterCallback getter = indexed_interceptor<Get, Set, Enum, Query, Del>::propertyGetter;
-		v8::NamedPropertySetterCallback setter = indexed_interceptor<Get, Set, Enum, Query, Del>::propertySetter;
-		v8::NamedPropertyEnumeratorCallback enumer = indexed_interceptor<Get, Set, Enum, Query, Del>::propertyEnumerator;
-		v8::NamedPropertyQueryCallback query = indexed_interceptor<Get, Set, Enum, Query, Del>::propertyQuery;
-		v8::NamedPropertyDeleterCallback del = indexed_interceptor<Get, Set, Enum, Query, Del>::propertyDel;
-
-		v8::Handle<v8::Value> data = detail::set_external_data(isolate(), indexer);
-
-		v8::NamedPropertyHandlerConfiguration config;
-		if (indexer.using_get)
-			config.getter = (v8::GenericNamedPropertyGetterCallback)getter;
-		if (indexer.using_set)
-			config.setter = (v8::GenericNamedPropertySetterCallback)setter;
-		if (indexer.using_enum)
-			config.enumerator = (v8::GenericNamedPropertyEnumeratorCallback)enumer;
-		if (indexer.using_query)
-			config.query = (v8::GenericNamedPropertyQueryCallback)query;
-		if (indexer.using_del)
-			config.deleter = (v8::GenericNamedPropertyDeleterCallback)del;
-
-		config.data = data;
-		config.flags = v8::PropertyHandlerFlags::kNonMasking;
-
-		class_singleton_.class_function_template()->PrototypeTemplate()->SetHandler(config);
-		has_handler = true;
-		return *this;
+		class_singleton_.set_has_handler();
+		return add_binding(&install_named_interceptor<true,
+			Get, Set, Enum, Query, Del>, "[named]", indexer);
 	}
 
 	/// Set value as a read-only property
@@ -827,8 +1484,8 @@ public:
 	class_& set_const(char const* name, Value value, bool dont_enum = false)
 	{
 		v8::HandleScope scope(isolate());
-		class_singleton_.js_function_template()->PrototypeTemplate()->Set(v8pp::to_v8(isolate(), name),
-			to_v8(isolate(), value), v8::PropertyAttribute(v8::ReadOnly | v8::DontDelete | (dont_enum ? v8::DontEnum : v8::None)));
+		class_singleton_.add_binding(&install_value<js_prototype>, name,
+			to_v8(isolate(), value), const_attrs(dont_enum));
 		return *this;
 	}
 
@@ -836,8 +1493,8 @@ public:
 	class_& set_js_const(char const* name, Value value, bool dont_enum = false)
 	{
 		v8::HandleScope scope(isolate());
-		class_singleton_.js_function_template()->Set(v8pp::to_v8(isolate(), name),
-			to_v8(isolate(), value), v8::PropertyAttribute(v8::ReadOnly | v8::DontDelete | (dont_enum ? v8::DontEnum : v8::None)));
+		class_singleton_.add_binding(&install_value<js_function>, name,
+			to_v8(isolate(), value), const_attrs(dont_enum));
 		return *this;
 	}
 
@@ -900,6 +1557,19 @@ public:
 		return class_singleton::instance(isolate).wrap_object(ext);
 	}
 
+	/// Create JavaScript object owning a value moved into a new C++ object
+	/// created by factory<T>, or copied inline for set_inline_values() class.
+	/// Used for values returned by C++ functions.
+	static v8::Handle<v8::Object> import_value(v8::Isolate* isolate, T&& value)
+	{
+		class_singleton& singleton = class_singleton::instance(isolate);
+		if (singleton.inline_values())
+		{
+			return singleton.wrap_value(value);
+		}
+		return singleton.wrap_object(factory<T>::create(isolate, std::move(value)));
+	}
+
 	//tries to find the object first if not found it references the object
 	static v8::Handle<v8::Object> find_or_reference(v8::Isolate* isolate, T* ext)
 	{
@@ -940,12 +1610,53 @@ public:
 		return class_singleton::instance(isolate).unwrap_object(value);
 	}
 
+	/// Get wrapped object for `this` of a callback, may return nullptr on fail.
+	/// Faster than unwrap_object for objects of exactly T class.
+	static T* unwrap_this(v8::Isolate* isolate, v8::Local<v8::Object> obj)
+	{
+		return class_singleton::instance(isolate).unwrap_this(obj);
+	}
+
+	/// Get wrapped object for a receiver guaranteed by the class v8::Signature,
+	/// the object must be a wrapper of T or a class derived from T
+	static T* unwrap_trusted(v8::Isolate* isolate, v8::Local<v8::Object> obj)
+	{
+		return class_singleton::instance(isolate).unwrap_trusted(obj);
+	}
+
 	/// Find V8 object handle for a wrapped C++ object, may return empty handle on fail.
 	static v8::Handle<v8::Object> find_object(v8::Isolate* isolate, T const* obj)
 	{
 		return class_singleton::instance(isolate).find_object(obj);
 	}
 
+	/// Count a named interceptor hit of the key, true if it should become own accessor
+	static bool count_key_hit(v8::Isolate* isolate, v8::Local<v8::String> name)
+	{
+		return class_singleton::instance(isolate).count_key_hit(name);
+	}
+
+	/// Object has changed its property values behind the promoted accessors:
+	/// remove them, the keys stay promoted for the class and get
+	/// accessors again on the next read
+	static void demote_keys(v8::Isolate* isolate, T const* obj)
+	{
+		class_singleton& singleton = class_singleton::instance(isolate);
+		v8::HandleScope scope(isolate);
+		v8::Local<v8::Object> v8_obj = singleton.find_object(obj);
+		if (!v8_obj.IsEmpty())
+		{
+			singleton.demote_keys(v8_obj);
+		}
+	}
+
+	/// Class schema has changed: remove promoted accessors of all objects,
+	/// count key hits and check key stability from the start
+	static void reset_promoted_keys(v8::Isolate* isolate)
+	{
+		class_singleton::instance(isolate).reset_promoted_keys();
+	}
+
 	/// Destroy wrapped C++ object
 	static void destroy_object(v8::Isolate* isolate, T* obj)
 	{
@@ -964,23 +1675,66 @@ public:
 		class_singleton::instance(isolate).destroy_objects();
 	}
 
-	bool set_class_name(char const* name, v8::Isolate *isolate)
+	/// Set how objects owned by JavaScript, wrapped by the constructor
+	/// or import_external(), are destroyed after garbage collection.
+	/// Other policies than destroy_immediate make weak callbacks only queue
+	/// the objects, the queue is drained after each GC or by drain_pending().
+	/// destroy_background deletes objects with `delete` on background_deleter
+	/// thread, only for classes created by the default factory<T> and
+	/// marked as thread_safe_destructible.
+	/// destroy_idle moves destruction off the GC path to context::idle_notification(),
+	/// the queue is drained after GC only when size of the queued objects,
+	/// factory<T>::object_size or sizeof(T), exceeds max_pending_bytes.
+	class_& set_destroy_policy(destroy_policy policy, size_t max_pending_bytes = 16 * 1024 * 1024)
 	{
-		if (!class_name_set)
-		{
-			class_function_template()->SetClassName(v8pp::to_v8(isolate, name));
-			
-			if (!has_handler)
-			{
-				v8pp::debug::set_debug_handler(js_function_template()->PrototypeTemplate(), name, isolate);
-				v8pp::debug::set_debug_handler(class_function_template()->PrototypeTemplate(), name, isolate);
-			}
+		class_singleton_.set_destroy_policy(policy, max_pending_bytes);
+		return *this;
+	}
 
-			class_name_set = true;
+	/// Store values of a small trivially copyable class inline: the constructor
+	/// and import_value() copy a value into a slot of an ArrayBuffer slab
+	/// for values_per_slab values, without factory<T> allocation, objects
+	/// registration and weak callback. Unwrapped pointers point into the slab
+	/// and are valid while the wrapper is alive, a slab is freed by GC after
+	/// all its wrappers. Values are not found by find_object().
+	/// Should be set before the class is used in JavaScript.
+	class_& set_inline_values(size_t values_per_slab = 1024)
+	{
+		static_assert(detail::is_inline_value<T>::value,
+			"inline values must be trivially copyable and not larger than V8PP_MAX_INLINE_VALUE_SIZE");
+		class_singleton_.set_inline_values(values_per_slab);
+		return *this;
+	}
 
-			return true;
-		}
-		return false;
+	/// Set v8::Signature on prototype methods, disabled by default: V8 checks
+	/// the method receiver is an instance of the class or a derived one, the
+	/// receiver is unwrapped without validation and the prototype chain walk.
+	/// Should not be enabled for a class which object is inserted as a context
+	/// global object prototype or used as a prototype of other objects.
+	class_& set_receiver_check(bool check)
+	{
+		class_singleton_.set_receiver_check(check);
+		return *this;
+	}
+
+	/// Destroy objects queued by a batched destroy policy now
+	static void drain_pending(v8::Isolate* isolate)
+	{
+		class_singleton::instance(isolate).drain_pending();
+	}
+
+	/// Set class name for the constructor function, only the first name is used
+	bool set_class_name(char const* name, v8::Isolate *isolate)
+	{
+		(void)isolate;
+		return class_singleton_.set_class_name(name);
+	}
+
+	/// Create V8 templates of the class now instead of on first use
+	class_& materialize()
+	{
+		class_singleton_.materialize();
+		return *this;
 	}
 
 	void get_all_objects(std::vector<T*> &objects)
@@ -989,12 +1743,198 @@ public:
 	}
 	
 private:
-	bool has_handler = false;
-	bool class_name_set = false;
+	using binding = typename class_singleton::binding;
+
+	/// Template of a value binding
+	enum binding_target { class_prototype, js_prototype, js_function };
+
+	static v8::PropertyAttribute accessor_attrs(bool readonly, bool dont_enum)
+	{
+		return v8::PropertyAttribute(v8::DontDelete | (readonly ? v8::ReadOnly : v8::None) | (dont_enum ? v8::DontEnum : v8::None));
+	}
+
+	static v8::PropertyAttribute const_attrs(bool dont_enum)
+	{
+		return v8::PropertyAttribute(v8::ReadOnly | v8::DontDelete | (dont_enum ? v8::DontEnum : v8::None));
+	}
+
+	/// Record a binding with a copy of C++ data, name is the profiler name of handlers
+	template<typename Data>
+	class_& add_binding(typename binding::install_function install, char const* name, Data const& data,
+		v8::PropertyAttribute attrs = v8::None, return_empty empty_return = NONE)
+	{
+		class_singleton_.add_data_binding(install, name, data, attrs, empty_return);
+		return *this;
+	}
+
+	template<binding_target Target>
+	static void install_value(class_singleton& singleton, binding const& b, v8::Local<v8::Value> data)
+	{
+		v8::Isolate* isolate = singleton.isolate();
+		v8::Local<v8::Template> tmpl;
+		switch (Target)
+		{
+		case class_prototype: tmpl = singleton.class_function_template()->PrototypeTemplate(); break;
+		case js_prototype: tmpl = singleton.js_function_template()->PrototypeTemplate(); break;
+		case js_function: tmpl = singleton.js_function_template(); break;
+		}
+		tmpl->Set(v8pp::to_v8(isolate, b.name), data, b.attrs);
+	}
+
+	template<typename U>
+	static void install_class_function(class_singleton& singleton, binding const& b, v8::Local<v8::Value> /*data*/)
+	{
+		detail::set_lazy_property<detail::lazy_class_function<U>>(
+			singleton.class_function_template()->PrototypeTemplate(), v8pp::to_v8(singleton.isolate(), b.name));
+	}
+
+	template<typename Method>
+	static void install_method(class_singleton& singleton, binding const& b, v8::Local<v8::Value> data)
+	{
+		v8::Isolate* isolate = singleton.isolate();
+		singleton.class_function_template()->PrototypeTemplate()->Set(v8pp::to_v8(isolate, b.name),
+			detail::method_template<Method>(isolate, data, singleton.signature(), b.empty_return), b.attrs);
+	}
+
+	template<typename Function>
+	static void install_function(class_singleton& singleton, binding const& b, v8::Local<v8::Value> data)
+	{
+		v8::Isolate* isolate = singleton.isolate();
+		singleton.js_function_template()->PrototypeTemplate()->Set(v8pp::to_v8(isolate, b.name),
+			detail::function_template<Function>(isolate, data), b.attrs);
+	}
+
+	template<v8::AccessorGetterCallback Getter, v8::AccessorSetterCallback Setter>
+	static void install_accessor(class_singleton& singleton, binding const& b, v8::Local<v8::Value> data)
+	{
+		v8::Isolate* isolate = singleton.isolate();
+		singleton.class_function_template()->PrototypeTemplate()->SetAccessor(v8pp::to_v8(isolate, b.name),
+			Getter, (b.attrs & v8::ReadOnly) ? nullptr : Setter, data, v8::DEFAULT, b.attrs);
+	}
+
+	template<v8::AccessorGetterCallback Getter>
+	static void install_getter(class_singleton& singleton, binding const& b, v8::Local<v8::Value> data)
+	{
+		v8::Isolate* isolate = singleton.isolate();
+		singleton.class_function_template()->PrototypeTemplate()->SetAccessor(v8pp::to_v8(isolate, b.name),
+			Getter, nullptr, data, v8::DEFAULT, b.attrs);
+	}
+
+	template<typename Property>
+	static void install_named_property(class_singleton& singleton, binding const& /*b*/, v8::Local<v8::Value> data)
+	{
+		v8::NamedPropertyHandlerConfiguration config;
+		config.getter = (v8::GenericNamedPropertyGetterCallback)Property::get;
+		if (!Property::is_readonly)
+		{
+			config.setter = (v8::GenericNamedPropertySetterCallback)Property::set;
+		}
+		config.data = data;
+		config.flags = v8::PropertyHandlerFlags::kNonMasking;
+
+		singleton.class_function_template()->PrototypeTemplate()->SetHandler(config);
+	}
+
+	/// Indexed handler of Property with query getter of Query property, void for none
+	template<typename Property, typename Query>
+	static void install_indexed_property(class_singleton& singleton, binding const& /*b*/, v8::Local<v8::Value> data)
+	{
+		v8::IndexedPropertyHandlerConfiguration config;
+		config.getter = (v8::IndexedPropertyGetterCallback)Property::get;
+		if (!Property::is_readonly)
+		{
+			config.setter = (v8::IndexedPropertySetterCallback)Property::set;
+		}
+		config.query = indexed_query<Query>(std::is_void<Query>());
+		config.data = data;
+		config.flags = v8::PropertyHandlerFlags::kNonMasking;
+
+		singleton.class_function_template()->PrototypeTemplate()->SetHandler(config);
+	}
+
+	template<typename Query>
+	static v8::IndexedPropertyQueryCallback indexed_query(std::true_type /*none*/)
+	{
+		return nullptr;
+	}
+
+	template<typename Query>
+	static v8::IndexedPropertyQueryCallback indexed_query(std::false_type)
+	{
+		return (v8::IndexedPropertyQueryCallback)Query::get;
+	}
+
+	template<typename Storage>
+	static void install_indexed_storage(class_singleton& singleton, binding const& /*b*/, v8::Local<v8::Value> data)
+	{
+		v8::IndexedPropertyHandlerConfiguration config(&Storage::get, &Storage::set,
+			&Storage::query, nullptr, &Storage::enumerate, data);
+
+		singleton.object_template()->SetHandler(config);
+	}
+
+	template<typename Get, typename Set, typename Enum, typename Query, typename Del>
+	static void install_indexed_interceptor(class_singleton& singleton, binding const& /*b*/, v8::Local<v8::Value> data)
+	{
+		using indexer = interceptor_data<Get, Set, Enum, Query, Del>;
+		using interceptor = indexed_interceptor<Get, Set, Enum, Query, Del>;
+
+		v8::IndexedPropertyHandlerConfiguration config;
+		if (indexer::using_get)
+			config.getter = interceptor::propertyGetter;
+		if (indexer::using_set)
+			config.setter = interceptor::propertySetter;
+		if (indexer::using_enum)
+			config.enumerator = interceptor::propertyEnumerator;
+		if (indexer::using_query)
+			config.query = interceptor::propertyQuery;
+		if (indexer::using_del)
+			config.deleter = interceptor::propertyDel;
+
+		config.data = data;
+		config.flags = v8::PropertyHandlerFlags::kNonMasking;
+
+		singleton.object_template()->SetHandler(config);
+	}
+
+	/// Named handler on the class prototype for Prototype, on the instances otherwise
+	template<bool Prototype, typename Get, typename Set, typename Enum, typename Query, typename Del>
+	static void install_named_interceptor(class_singleton& singleton, binding const& /*b*/, v8::Local<v8::Value> data)
+	{
+		using indexer = interceptor_data<Get, Set, Enum, Query, Del>;
+		using interceptor = indexed_interceptor<Get, Set, Enum, Query, Del>;
+
+		v8::NamedPropertyGetterCallback getter = interceptor::propertyGetter;
+		v8::NamedPropertySetterCallback setter = interceptor::propertySetter;
+		v8::NamedPropertyEnumeratorCallback enumer = interceptor::propertyEnumerator;
+		v8::NamedPropertyQueryCallback query = interceptor::propertyQuery;
+		v8::NamedPropertyDeleterCallback del = interceptor::propertyDel;
+
+		v8::NamedPropertyHandlerConfiguration config;
+		if (indexer::using_get)
+			config.getter = (v8::GenericNamedPropertyGetterCallback)getter;
+		if (indexer::using_set)
+			config.setter = (v8::GenericNamedPropertySetterCallback)setter;
+		if (indexer::using_enum)
+			config.enumerator = (v8::GenericNamedPropertyEnumeratorCallback)enumer;
+		if (indexer::using_query)
+			config.query = (v8::GenericNamedPropertyQueryCallback)query;
+		if (indexer::using_del)
+			config.deleter = (v8::GenericNamedPropertyDeleterCallback)del;
+
+		config.data = data;
+		config.flags = v8::PropertyHandlerFlags::kNonMasking;
+
+		v8::Local<v8::ObjectTemplate> tmpl = Prototype
+			? singleton.class_function_template()->PrototypeTemplate() : singleton.object_template();
+		tmpl->SetHandler(config);
+	}
+
 	template<typename Attribute>
 	static void member_get(v8::Local<v8::String>, v8::PropertyCallbackInfo<v8::Value> const& info)
 	{
 		v8::Isolate* isolate = info.GetIsolate();
+		V8PP_PROFILE_CALL(isolate, info.Data(), op_get);
 
 		T const& self = v8pp::from_v8<T const&>(isolate, info.This());
 		Attribute attr = detail::get_external_data<Attribute>(info.Data());
@@ -1005,6 +1945,7 @@ private:
 	static void member_set(v8::Local<v8::String>, v8::Local<v8::Value> value, v8::PropertyCallbackInfo<void> const& info)
 	{
 		v8::Isolate* isolate = info.GetIsolate();
+		V8PP_PROFILE_CALL(isolate, info.Data(), op_set);
 
 		T& self = v8pp::from_v8<T&>(isolate, info.This());
 		Attribute ptr = detail::get_external_data<Attribute>(info.Data());
@@ -6,11 +6,39 @@
 #define V8PP_ISOLATE_DATA_SLOT 0
 #endif
 
+/// v8::Isolate data slot number for the context owning the isolate
+#if !defined(V8PP_CONTEXT_DATA_SLOT)
+#define V8PP_CONTEXT_DATA_SLOT 1
+#endif
+
+/// v8::Isolate data slot number for the binding profiler
+#if !defined(V8PP_PROFILER_DATA_SLOT)
+#define V8PP_PROFILER_DATA_SLOT 2
+#endif
+
+/// v8::Isolate data slot number for the plugin manager
+#if !defined(V8PP_PLUGIN_MANAGER_DATA_SLOT)
+#define V8PP_PLUGIN_MANAGER_DATA_SLOT 3
+#endif
+
+/// Max size of a class stored inline in JavaScript wrappers, see class_::set_inline_values()
+#if !defined(V8PP_MAX_INLINE_VALUE_SIZE)
+#define V8PP_MAX_INLINE_VALUE_SIZE 64
+#endif
+
 /// v8pp plugin initialization procedure name
 #if !defined(V8PP_PLUGIN_INIT_PROC_NAME)
 #define V8PP_PLUGIN_INIT_PROC_NAME v8pp_module_init
 #endif
 
+/// v8pp plugin descriptor procedure name
+#if !defined(V8PP_PLUGIN_DESCRIPTOR_PROC_NAME)
+#define V8PP_PLUGIN_DESCRIPTOR_PROC_NAME v8pp_plugin_descriptor
+#endif
+
+/// v8pp plugin descriptor ABI version, changed on incompatible descriptor layout changes
+#define V8PP_PLUGIN_ABI_VERSION 1
+
 /// v8pp plugin filename suffix
 #if !defined(V8PP_PLUGIN_SUFFIX)
 	#if defined(WIN32)
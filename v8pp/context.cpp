@@ -9,22 +9,16 @@
 
 #include "v8pp/any_object_hidden.h"
 #include "v8pp/isolate_watcher.h"
+#include "v8pp/persistent.hpp"
+#include "v8pp/plugin_manager.hpp"
+#include "v8pp/profiler.hpp"
+#include "v8pp/watchdog.hpp"
 
+#include <algorithm>
 #include <fstream>
 
-#if defined(WIN32)
-#include <windows.h>
-static char const path_sep = '\\';
-#else
-#include <dlfcn.h>
-static char const path_sep = '/';
-#endif
-
 std::map<v8::Isolate *, isolate_watcher> isolate_watcher::watcher_per_isolate;
 
-#define STRINGIZE(s) STRINGIZE0(s)
-#define STRINGIZE0(s) #s
-
 namespace v8pp {
 
 	struct context::dynamic_module
@@ -65,47 +59,43 @@ namespace v8pp {
 			{
 				result = v8::Local<v8::Value>::New(isolate, it->second.exports);
 			}
-			else
+			else if (plugin_manager* plugins = plugin_manager::get(isolate))
 			{
-				std::string filename = name;
-				if (!ctx->lib_path_.empty())
-				{
-					filename = ctx->lib_path_ + path_sep + name;
-				}
-				std::string const suffix = V8PP_PLUGIN_SUFFIX;
-				if (filename.size() >= suffix.size()
-					&& filename.compare(filename.size() - suffix.size(), suffix.size(), suffix) != 0)
+				// libraries are shared by contexts of the isolate,
+				// dependencies are initialized first
+				std::string const& lib_path = ctx->lib_path_.empty() ? plugins->lib_path() : ctx->lib_path_;
+				for (plugin_manager::plugin const* plugin : plugins->resolve(name, lib_path))
 				{
-					filename += suffix;
+					it = ctx->modules_.find(plugin->name);
+					if (it == ctx->modules_.end())
+					{
+						dynamic_module module;
+						module.handle = nullptr;
+						module.exports.Reset(isolate, plugins->create_exports(*plugin));
+						it = ctx->modules_.emplace(plugin->name, std::move(module)).first;
+					}
 				}
-
-				dynamic_module module;
-#if defined(WIN32)
-				UINT const prev_error_mode = SetErrorMode(SEM_NOOPENFILEERRORBOX);
-				module.handle = LoadLibraryA(filename.c_str());
-				::SetErrorMode(prev_error_mode);
-#else
-				module.handle = dlopen(filename.c_str(), RTLD_LAZY);
-#endif
-
-				if (!module.handle)
+				result = v8::Local<v8::Value>::New(isolate, it->second.exports);
+			}
+			else
+			{
+				plugin_manager::plugin plugin;
+				plugin.name = name;
+				plugin_manager::load(plugin, ctx->lib_path_, false);
+				if (!plugin.handle)
 				{
-					throw std::runtime_error("load_module(" + name + "): could not load shared library " + filename);
+					throw std::runtime_error("load_module(" + name + "): " + plugin.error);
 				}
-#if defined(WIN32)
-				void *sym = ::GetProcAddress((HMODULE)module.handle, STRINGIZE(V8PP_PLUGIN_INIT_PROC_NAME));
-#else
-				void *sym = dlsym(module.handle, STRINGIZE(V8PP_PLUGIN_INIT_PROC_NAME));
-#endif
-				if (!sym)
+				if (!plugin.init)
 				{
-					throw std::runtime_error("load_module(" + name + "): initialization function "
-						STRINGIZE(V8PP_PLUGIN_INIT_PROC_NAME) " not found in " + filename);
+					plugin_manager::unload(plugin.handle);
+					throw std::runtime_error("load_module(" + name + "): " + plugin.filename
+						+ " has only a plugin descriptor, it requires plugin_manager");
 				}
 
-				using module_init_proc = v8::Handle<v8::Value>(*)(v8::Isolate*);
-				module_init_proc init_proc = reinterpret_cast<module_init_proc>(sym);
-				result = init_proc(isolate);
+				dynamic_module module;
+				module.handle = plugin.handle;
+				result = plugin.init(isolate);
 				module.exports.Reset(isolate, result);
 				ctx->modules_.emplace(name, std::move(module));
 			}
@@ -161,39 +151,233 @@ namespace v8pp {
 		args.GetReturnValue().Set(scope.Escape(result));
 	}
 
-struct array_buffer_allocator : v8::ArrayBuffer::Allocator
-{
-	void* Allocate(size_t length)
+	/// Arms the watchdog for the outermost script run in the context
+	class context::execution_scope
+	{
+	public:
+		execution_scope(context& ctx, execution_limit const& limit)
+			: ctx_(ctx)
+			, ticket_(0)
+			, outermost_(ctx.run_depth_++ == 0)
+		{
+			if (outermost_)
+			{
+				ctx_.last_termination_ = termination_reason::none;
+				if (!limit.unlimited())
+				{
+					ticket_ = watchdog::instance().arm(ctx_.isolate_, limit.wall_time, limit.cpu_time);
+				}
+			}
+		}
+
+		~execution_scope()
+		{
+			disarm();
+			--ctx_.run_depth_;
+		}
+
+		/// Record result of the run, returns false if the script was terminated
+		bool finish(v8::TryCatch const& try_catch, bool succeeded)
+		{
+			termination_reason const reason = disarm();
+			if (outermost_ && !succeeded)
+			{
+				ctx_.last_termination_ = try_catch.HasTerminated() && reason != termination_reason::none ?
+					reason : termination_reason::exception;
+			}
+			return !try_catch.HasTerminated();
+		}
+
+	private:
+		/// Returns reason of termination made by the context
+		termination_reason disarm()
+		{
+			termination_reason reason = termination_reason::none;
+			if (ticket_)
+			{
+				if (watchdog::instance().disarm(ticket_))
+				{
+					reason = termination_reason::timeout;
+				}
+				ticket_ = 0;
+			}
+			if (outermost_ && ctx_.heap_terminating_)
+			{
+				reason = termination_reason::out_of_memory;
+				ctx_.heap_terminating_ = false;
+			}
+			if (reason != termination_reason::none)
+			{
+				// make the isolate usable again, also when
+				// termination was requested after the script end
+				ctx_.isolate_->CancelTerminateExecution();
+			}
+			return reason;
+		}
+
+		context& ctx_;
+		watchdog::ticket ticket_;
+		bool const outermost_;
+	};
+
+	void context::check_heap_limit(v8::Isolate* isolate, v8::GCType, v8::GCCallbackFlags)
 	{
-		return calloc(length, 1);
+		context* ctx = static_cast<context*>(isolate->GetData(V8PP_CONTEXT_DATA_SLOT));
+		if (!ctx)
+		{
+			return;
+		}
+
+		v8::HeapStatistics stats;
+		isolate->GetHeapStatistics(&stats);
+
+		heap_metrics& metrics = ctx->heap_stats_;
+		metrics.heap_size_limit = stats.heap_size_limit();
+		if (stats.used_heap_size() > metrics.peak_used_heap_size)
+		{
+			metrics.peak_used_heap_size = stats.used_heap_size();
+		}
+
+		// terminate the running script before V8 fails with a fatal OOM error
+		if (ctx->run_depth_ > 0 && !ctx->heap_terminating_
+			&& stats.used_heap_size() > ctx->heap_limit_ratio_ * stats.heap_size_limit())
+		{
+			ctx->heap_terminating_ = true;
+			++metrics.near_limit_count;
+			isolate->TerminateExecution();
+		}
 	}
-	void* AllocateUninitialized(size_t length)
+
+	struct context::js_timer
 	{
-		return malloc(length);
+		persistent<v8::Function> function;
+		std::vector<persistent<v8::Value>> args;
+	};
+
+	void context::start_timer(v8::FunctionCallbackInfo<v8::Value> const& args, bool repeat)
+	{
+		v8::Isolate* isolate = args.GetIsolate();
+
+		v8::HandleScope scope(isolate);
+		try
+		{
+			if (args.Length() < 1 || !args[0]->IsFunction())
+			{
+				throw std::runtime_error(repeat ? "setInterval: require function argument"
+					: "setTimeout: require function argument");
+			}
+			// NaN and negative delays are 0, conversion of Infinity to integer is undefined
+			double delay = from_v8<double>(isolate, args[1], 0.0);
+			delay = delay > 0 ? std::min(delay, static_cast<double>(event_loop::max_delay)) : 0;
+
+			std::shared_ptr<js_timer> timer = std::make_shared<js_timer>();
+			timer->function = persistent<v8::Function>(isolate, args[0].As<v8::Function>());
+			for (int i = 2; i < args.Length(); ++i)
+			{
+				timer->args.emplace_back(isolate, args[i]);
+			}
+
+			context* ctx = detail::get_external_data<context*>(args.Data());
+			event_loop::timer_id const id = ctx->loop_->set_timer([ctx, timer]() { ctx->call_timer(*timer); },
+				std::chrono::milliseconds(static_cast<int64_t>(delay)), repeat);
+			args.GetReturnValue().Set(id);
+		}
+		catch (std::exception const& ex)
+		{
+			args.GetReturnValue().Set(throw_ex(isolate, ex.what()));
+		}
+	}
+
+	void context::set_timeout(v8::FunctionCallbackInfo<v8::Value> const& args)
+	{
+		start_timer(args, false);
+	}
+
+	void context::set_interval(v8::FunctionCallbackInfo<v8::Value> const& args)
+	{
+		start_timer(args, true);
 	}
-	void Free(void* data, size_t length)
+
+	void context::clear_timer(v8::FunctionCallbackInfo<v8::Value> const& args)
 	{
-		free(data);
+		v8::Isolate* isolate = args.GetIsolate();
+
+		v8::HandleScope scope(isolate);
+		event_loop::timer_id const id = from_v8<event_loop::timer_id>(isolate, args[0], 0);
+		if (id)
+		{
+			context* ctx = detail::get_external_data<context*>(args.Data());
+			ctx->loop_->clear_timer(id);
+		}
 	}
-};
 
-static array_buffer_allocator array_buffer_allocator_;
+	void context::call_timer(js_timer& timer)
+	{
+		v8::HandleScope scope(isolate_);
+		v8::Local<v8::Context> impl = to_local(isolate_, impl_);
+		v8::Context::Scope context_scope(impl);
+
+		std::vector<v8::Local<v8::Value>> argv;
+		argv.reserve(timer.args.size());
+		for (persistent<v8::Value> const& arg : timer.args)
+		{
+			argv.push_back(to_local(isolate_, arg));
+		}
+
+		execution_scope execution(*this, limit_);
+		v8::TryCatch try_catch(isolate_);
+		v8::Local<v8::Value> result;
+		bool const succeeded = to_local(isolate_, timer.function)->Call(impl, impl->Global(),
+			static_cast<int>(argv.size()), argv.empty() ? nullptr : &argv[0]).ToLocal(&result);
+		if (execution.finish(try_catch, succeeded) && !succeeded)
+		{
+			ReportException(&try_catch);
+		}
+	}
 
 context::context(v8::Isolate* isolate, 
 	context_callback create_global,
 	global_object_callback wrap_global,
-	bool allow_java_run)
+	bool allow_java_run,
+	isolate_params const& params)
 {
 	own_isolate_ = (isolate == nullptr);
+	last_termination_ = termination_reason::none;
+	run_depth_ = 0;
+	heap_limit_ratio_ = params.heap_limit_ratio;
+	heap_terminating_ = false;
+	allocator_ = nullptr;
+	allocator_detached_ = false;
 	if (own_isolate_)
 	{
+		allocator_ = params.allocator;
+		if (!allocator_)
+		{
+			own_allocator_.reset(new malloc_allocator);
+			allocator_ = own_allocator_.get();
+		}
+
 		v8::Isolate::CreateParams create_params;
-		create_params.array_buffer_allocator = &array_buffer_allocator_;
+		create_params.array_buffer_allocator = allocator_;
+
+		v8::ResourceConstraints& constraints = create_params.constraints;
+		if (params.max_old_space_size)
+			constraints.set_max_old_space_size(static_cast<int>(params.max_old_space_size));
+		if (params.max_semi_space_size)
+			constraints.set_max_semi_space_size(static_cast<int>(params.max_semi_space_size));
+		if (params.max_executable_size)
+			constraints.set_max_executable_size(static_cast<int>(params.max_executable_size));
+		if (params.code_range_size)
+			constraints.set_code_range_size(params.code_range_size);
 
 		isolate = v8::Isolate::New(create_params);
 		isolate->Enter();
+
+		isolate->SetData(V8PP_CONTEXT_DATA_SLOT, this);
+		isolate->AddGCEpilogueCallback(check_heap_limit);
 	}
 	isolate_ = isolate;
+	loop_.reset(new event_loop(isolate_));
 
 	v8::HandleScope scope(isolate_);
 
@@ -218,6 +402,11 @@ context::context(v8::Isolate* isolate,
 		global->Set(isolate_, "require", v8::FunctionTemplate::New(isolate_, context::load_module, data));
 		global->Set(isolate_, "run", v8::FunctionTemplate::New(isolate_, context::run_file, data));
 	}
+
+	global->Set(isolate_, "setTimeout", v8::FunctionTemplate::New(isolate_, context::set_timeout, data));
+	global->Set(isolate_, "setInterval", v8::FunctionTemplate::New(isolate_, context::set_interval, data));
+	global->Set(isolate_, "clearTimeout", v8::FunctionTemplate::New(isolate_, context::clear_timer, data));
+	global->Set(isolate_, "clearInterval", v8::FunctionTemplate::New(isolate_, context::clear_timer, data));
 	
 	v8::Handle<v8::Context> impl = v8::Context::New(isolate_, nullptr, global, global_obj);
 
@@ -240,7 +429,12 @@ v8::Isolate *context::detach_isolate()
 		return nullptr;
 
 	own_isolate_ = false;
+	isolate_->RemoveGCEpilogueCallback(check_heap_limit);
+	isolate_->SetData(V8PP_CONTEXT_DATA_SLOT, nullptr);
 	get_context()->Exit();
+
+	// the isolate uses the allocator after the context destruction
+	allocator_detached_ = own_allocator_.release() != nullptr;
 	return isolate_;
 }
 
@@ -250,23 +444,29 @@ bool context::attach_isolate()
 		return false;
 
 	own_isolate_ = true;
+	if (allocator_detached_)
+	{
+		own_allocator_.reset(allocator_);
+		allocator_detached_ = false;
+	}
+	isolate_->SetData(V8PP_CONTEXT_DATA_SLOT, this);
+	isolate_->AddGCEpilogueCallback(check_heap_limit);
 	get_context()->Enter();
 	return true;
 }
 
 context::~context()
 {
+	// pending timers hold persistent handles of the isolate
+	loop_->clear();
+
 	for (auto& kv : modules_)
 	{
 		dynamic_module& module = kv.second;
 		module.exports.Reset();
 		if (module.handle)
 		{
-#if defined(WIN32)
-			::FreeLibrary((HMODULE)module.handle);
-#else
-			dlclose(module.handle);
-#endif
+			plugin_manager::unload(module.handle);
 		}
 	}
 	modules_.clear();
@@ -289,6 +489,7 @@ context::~context()
 			for (size_t x = 0; x < singletons->size(); x++)
 			{
 				detail::class_info* class_in = ((detail::class_info*)singletons->at(x));
+				if (!class_in) continue;
 				class_in->remove_class_info();
 				//ref_static::ref_count;
 			}
@@ -301,6 +502,11 @@ context::~context()
 	impl_.Reset();
 	if (own_isolate_)
 	{
+		isolate_->RemoveGCEpilogueCallback(check_heap_limit);
+		isolate_->SetData(V8PP_CONTEXT_DATA_SLOT, nullptr);
+		profiler::remove(isolate_);
+		plugin_manager::remove(isolate_);
+
 		detail::external_info::delete_isolate_instance(isolate_);
 		value_watcher::delete_isolate_instance(isolate_);
 		isolate_watcher::delete_isolate_instance(isolate_);
@@ -312,6 +518,36 @@ context::~context()
 	}
 }
 
+bool context::idle_notification(std::chrono::milliseconds budget)
+{
+	using clock = std::chrono::steady_clock;
+	using singleton_instances = std::vector<void*>;
+
+	clock::time_point const deadline = clock::now() + budget;
+
+	bool done = true;
+	singleton_instances* singletons =
+		static_cast<singleton_instances*>(isolate_->GetData(V8PP_ISOLATE_DATA_SLOT));
+	if (singletons)
+	{
+		for (size_t x = 0; x < singletons->size() && done; x++)
+		{
+			detail::class_info* class_in = ((detail::class_info*)singletons->at(x));
+			if (class_in)
+			{
+				done = class_in->drain_idle(deadline);
+			}
+		}
+	}
+
+	auto const remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - clock::now());
+	if (remaining.count() > 0)
+	{
+		done = isolate_->IdleNotification(static_cast<int>(remaining.count())) && done;
+	}
+	return done;
+}
+
 v8::Local<v8::Context> context::get_context()
 {
 	return to_local(isolate_, impl_);
@@ -379,35 +615,40 @@ void context::execPrintScript(std::string const& source, std::string const& file
 }
 
 v8::Handle<v8::Value> context::run_script(std::string const& source, std::string const& filename, bool report_exception)
+{
+	return run_script(source, limit_, filename, report_exception);
+}
+
+v8::Handle<v8::Value> context::run_script(std::string const& source, execution_limit const& limit,
+	std::string const& filename, bool report_exception)
 {
 	v8::EscapableHandleScope scope(isolate_);
 	if (!own_isolate_)
 		to_local(isolate_, impl_)->Enter();
 	
 	v8::Local<v8::Value> result;
-	v8::TryCatch try_catch(isolate_);
-	//try_catch.SetVerbose(true);
-	v8::Local<v8::Script> script = v8::Script::Compile(
-		to_v8(isolate_, source), to_v8(isolate_, filename));
-
-	if (!script.IsEmpty())
 	{
-		//result = script->Run();
-		if (!script->Run(v8pp::to_local(isolate_, impl_)).ToLocal(&result))
+		execution_scope execution(*this, limit);
+		v8::TryCatch try_catch(isolate_);
+		//try_catch.SetVerbose(true);
+		v8::Local<v8::Script> script = v8::Script::Compile(
+			to_v8(isolate_, source), to_v8(isolate_, filename));
+
+		bool succeeded = false;
+		if (!script.IsEmpty())
+		{
+			//result = script->Run();
+			succeeded = script->Run(v8pp::to_local(isolate_, impl_)).ToLocal(&result);
+			assert(succeeded != try_catch.HasCaught());
+		}
+
+		// terminated scripts have no exception to report
+		if (execution.finish(try_catch, succeeded) && !succeeded)
 		{
-			assert(try_catch.HasCaught());
 			// Print errors that happened during execution.
 			if (report_exception)
 				ReportException(&try_catch);
-			//return false;
 		}
-		else
-			assert(!try_catch.HasCaught());
-	}
-	else
-	{
-		if (report_exception)
-			ReportException(&try_catch);
 	}
 
 	if (!own_isolate_)
@@ -9,12 +9,17 @@
 #ifndef V8PP_CONTEXT_HPP_INCLUDED
 #define V8PP_CONTEXT_HPP_INCLUDED
 
+#include <chrono>
 #include <string>
 #include <map>
+#include <memory>
 
 #include <v8.h>
 
+#include "v8pp/array_buffer_allocator.hpp"
 #include "v8pp/convert.hpp"
+#include "v8pp/event_loop.hpp"
+#include "v8pp/lazy_property.hpp"
 #include "v8pp/property.hpp"
 #include <functional>
 
@@ -24,9 +29,86 @@ namespace v8pp {
 
 	class module;
 
+	/// Why the last script run has stopped
+	enum class termination_reason
+	{
+		none,       ///< completed or still running
+		exception,  ///< compilation error or uncaught exception
+		timeout,    ///< execution limit exceeded
+		out_of_memory, ///< heap limit of the isolate is almost reached
+	};
+
+	/// Resource constraints for an isolate created by context, sizes in megabytes.
+	/// Zero size means V8 default.
+	struct isolate_params
+	{
+		size_t max_old_space_size;
+		size_t max_semi_space_size;
+		size_t max_executable_size;
+		size_t code_range_size;
+
+		/// Running script is terminated when used heap size after a GC
+		/// exceeds this part of the heap size limit
+		double heap_limit_ratio;
+
+		/// ArrayBuffer allocator for the isolate, not owned, must outlive the context.
+		/// Context creates own malloc_allocator if it's nullptr.
+		array_buffer_allocator* allocator;
+
+		isolate_params()
+			: max_old_space_size(0)
+			, max_semi_space_size(0)
+			, max_executable_size(0)
+			, code_range_size(0)
+			, heap_limit_ratio(0.9)
+			, allocator(nullptr)
+		{
+		}
+	};
+
+	/// Heap usage of an isolate owned by context
+	struct heap_metrics
+	{
+		size_t heap_size_limit;
+		size_t peak_used_heap_size;
+		size_t near_limit_count;  ///< number of scripts terminated on the heap limit
+
+		heap_metrics()
+			: heap_size_limit(0)
+			, peak_used_heap_size(0)
+			, near_limit_count(0)
+		{
+		}
+	};
+
+	/// Time budget for a script run, zero duration means no limit
+	struct execution_limit
+	{
+		std::chrono::milliseconds wall_time;
+		std::chrono::milliseconds cpu_time;
+
+		execution_limit()
+			: wall_time(0), cpu_time(0)
+		{
+		}
+
+		explicit execution_limit(std::chrono::milliseconds wall_time,
+			std::chrono::milliseconds cpu_time = std::chrono::milliseconds(0))
+			: wall_time(wall_time), cpu_time(cpu_time)
+		{
+		}
+
+		bool unlimited() const { return wall_time.count() <= 0 && cpu_time.count() <= 0; }
+	};
+
 	template<typename T>
 	class class_;
 
+	namespace detail {
+		template<typename T>
+		struct lazy_class_function;
+	} // namespace detail
+
 	/// V8 isolate and context wrapper
 	class context
 	{
@@ -53,19 +135,26 @@ namespace v8pp {
 		///			 context is created if template object is going to be reused to
 		///			 create another context.
 		///				- Add them to the global object itself
+		///
+		/// Use binding_set to install the same bindings into many contexts
+		/// of an isolate without running the binding code for each context.
 		/// 
 		//////////////////////////////////////////////////////////////////////////
 		explicit context(v8::Isolate* isolate = nullptr,
 			context_callback create_global = context_callback(),
 			global_object_callback wrap_global = global_object_callback(),
-			bool allow_java_run = true);
+			bool allow_java_run = true,
+			isolate_params const& params = isolate_params());
 		~context();
 
 		/// Prevents clean up of the isolate if the isolate is removed before deleting the context
-		/// Returns nullptr if the isolate was not owned by this context
+		/// Returns nullptr if the isolate was not owned by this context.
+		/// The caller owns the isolate and the allocator() created by the context
+		/// for the isolate, the allocator should be deleted after the isolate disposal
 		v8::Isolate *detach_isolate();
 
-		/// Gives the isolate back so that the isolate is cleaned up when context is deleted
+		/// Gives the isolate back so that the isolate is cleaned up when context is deleted,
+		/// the context owns again its allocator() released on detach_isolate()
 		/// Returns false if failed to take the isolate
 		bool attach_isolate();
 
@@ -76,6 +165,23 @@ namespace v8pp {
 		/// V8 isolate associated with this context
 		v8::Isolate* isolate() { return isolate_; }
 
+		/// Event loop for timers and posted tasks of this context
+		event_loop& loop() { return *loop_; }
+
+		/// Run the event loop until there are no tasks and timers left
+		void run_until_idle() { loop_->run_until_idle(); }
+
+		/// Run the event loop for the duration
+		void run_for(event_loop::clock::duration duration) { loop_->run_for(duration); }
+
+		/// Run pending microtasks
+		void run_microtasks() { loop_->run_microtasks(); }
+
+		/// Idle time hook for the embedder: destroy objects queued by
+		/// destroy_idle policy of wrapped classes and let V8 do its idle
+		/// work within the time budget. Returns true if there is nothing left to do
+		bool idle_notification(std::chrono::milliseconds budget);
+
 		/// Library search path
 		std::string const& lib_path() const { return lib_path_; }
 
@@ -90,6 +196,29 @@ namespace v8pp {
 		/// The same as run_file but uses string as the script source
 		v8::Handle<v8::Value> run_script(std::string const& source, std::string const& filename = "", bool report_exception =  true);
 
+		/// Run script with own execution limit instead of the context one
+		v8::Handle<v8::Value> run_script(std::string const& source, execution_limit const& limit,
+			std::string const& filename = "", bool report_exception = true);
+
+		/// Execution limit for scripts and timer callbacks, unlimited by default.
+		/// The script is terminated when it runs out of the limit and
+		/// the context stays usable.
+		void set_execution_limit(execution_limit const& limit) { limit_ = limit; }
+		execution_limit const& get_execution_limit() const { return limit_; }
+
+		/// Why the last script or timer callback run has stopped
+		termination_reason last_termination() const { return last_termination_; }
+
+		/// ArrayBuffer allocator of own isolate, nullptr for external isolate
+		array_buffer_allocator* allocator() { return allocator_; }
+
+		/// Heap usage collected for own isolate
+		heap_metrics const& heap_stats() const { return heap_stats_; }
+
+		/// A script was terminated near the heap limit. The isolate may have
+		/// no room for further work, dispose the context and create a new one.
+		bool heap_exhausted() const { return heap_stats_.near_limit_count != 0; }
+
 		//executes script and prints to console
 		void execPrintScript(std::string const& source, std::string const& filename, bool report_exception = true);
 
@@ -99,14 +228,15 @@ namespace v8pp {
 		/// Set module to the context global object
 		context& set(char const *name, module& m);
 
-		/// Set class to the context global object
+		/// Set class to the context global object. The class templates
+		/// and constructor function are created on first access from JavaScript
 		template<typename T>
 		context& set(char const* name, class_<T>& cl)
 		{
 			v8::HandleScope scope(isolate_);
-			//cl.class_function_template()->SetClassName(v8pp::to_v8(isolate_, name));
 			cl.set_class_name(name, isolate_);
-			return set(name, cl.js_function_template()->GetFunction());
+			detail::set_lazy_property<detail::lazy_class_function<T>>(global(), v8pp::to_v8(isolate_, name));
+			return *this;
 		}
 
 		context& set(char const* name, context &other_context);
@@ -138,6 +268,7 @@ namespace v8pp {
 			}
 
 			v8::Handle<v8::Value> data = detail::set_external_data(isolate_, prop);
+			V8PP_PROFILE_NAME(isolate_, data, nullptr, name);
 			v8::PropertyAttribute const prop_attrs = v8::PropertyAttribute(v8::DontDelete | (setter ? 0 : v8::ReadOnly));
 
 			global_prototype()->SetAccessor(v8pp::to_v8(isolate(), name), getter, setter, data, v8::DEFAULT, prop_attrs);
@@ -165,8 +296,32 @@ namespace v8pp {
 		static void run_file(v8::FunctionCallbackInfo<v8::Value> const& args);
 		static void run_source(v8::FunctionCallbackInfo<v8::Value> const& args);
 
+		struct js_timer;
+		class execution_scope;
+
+		static void set_timeout(v8::FunctionCallbackInfo<v8::Value> const& args);
+		static void set_interval(v8::FunctionCallbackInfo<v8::Value> const& args);
+		static void clear_timer(v8::FunctionCallbackInfo<v8::Value> const& args);
+		static void start_timer(v8::FunctionCallbackInfo<v8::Value> const& args, bool repeat);
+		void call_timer(js_timer& timer);
+
+		static void check_heap_limit(v8::Isolate* isolate, v8::GCType type, v8::GCCallbackFlags flags);
+
 		dynamic_modules modules_;
 		std::string lib_path_;
+		std::unique_ptr<event_loop> loop_;
+
+		execution_limit limit_;
+		termination_reason last_termination_;
+		int run_depth_;
+
+		double heap_limit_ratio_;
+		heap_metrics heap_stats_;
+		bool heap_terminating_;
+
+		std::unique_ptr<array_buffer_allocator> own_allocator_;
+		array_buffer_allocator* allocator_;
+		bool allocator_detached_; ///< own allocator released with the isolate
 	};
 
 } // namespace v8pp
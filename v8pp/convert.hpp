@@ -51,6 +51,56 @@ struct convertible_string : std::basic_string<Char>, ref_debug<convertible_strin
 
 } // namespace detail
 
+/// Borrowed UTF-8 string, valid only during the call it was passed to.
+/// Named interceptor handlers with a string_view argument get the property
+/// name without a memory allocation for names up to 128 bytes.
+class string_view
+{
+public:
+	string_view()
+		: data_(nullptr), size_(0)
+	{
+	}
+
+	string_view(char const* data, size_t size)
+		: data_(data), size_(size)
+	{
+	}
+
+	string_view(std::string const& str)
+		: data_(str.data()), size_(str.size())
+	{
+	}
+
+	char const* data() const { return data_; }
+	size_t size() const { return size_; }
+	bool empty() const { return size_ == 0; }
+
+	char const* begin() const { return data_; }
+	char const* end() const { return data_ + size_; }
+
+	char operator[](size_t pos) const { return data_[pos]; }
+
+	std::string str() const { return std::string(data_, size_); }
+
+	bool operator==(string_view other) const
+	{
+		return size_ == other.size_ && std::char_traits<char>::compare(data_, other.data_, size_) == 0;
+	}
+
+	bool operator==(char const* str) const
+	{
+		return *this == string_view(str, std::char_traits<char>::length(str));
+	}
+
+	bool operator!=(string_view other) const { return !(*this == other); }
+	bool operator!=(char const* str) const { return !(*this == str); }
+
+private:
+	char const* data_;
+	size_t size_;
+};
+
 template<typename T>
 class class_;
 
@@ -168,6 +218,25 @@ struct convert< std::basic_string<Char, Traits, Alloc>>
 	}
 };
 
+// string_view is converted only to V8, a view can't own the string data
+template<>
+struct convert<string_view>
+{
+	using from_type = string_view;
+	using to_type = v8::Handle<v8::String>;
+
+	static bool is_valid(v8::Isolate*, v8::Handle<v8::Value> value)
+	{
+		return !value.IsEmpty() && value->IsString();
+	}
+
+	static to_type to_v8(v8::Isolate* isolate, string_view value)
+	{
+		return v8::String::NewFromUtf8(isolate, value.data(),
+			v8::String::kNormalString, static_cast<int>(value.size()));
+	}
+};
+
 template<typename Char>
 struct convert<Char const*>
 {
@@ -705,6 +774,12 @@ struct convert<T, typename std::enable_if<is_wrapped_class<T>::value>::type>
 	{
 		return convert<T*>::to_v8(isolate, &value);
 	}
+
+	/// A value returned by C++ function is moved into a new object owned by JavaScript
+	static to_type to_v8(v8::Isolate* isolate, T&& value)
+	{
+		return class_<T>::import_value(isolate, std::move(value));
+	}
 };
 
 template<typename T>
@@ -749,12 +824,39 @@ typename convert<T>::to_type to_v8(v8::Isolate* isolate, T & value)
 	return convert<T>::to_v8(isolate, value);
 }
 
+/// Wrapped class temporary, usually a value returned by C++ function
+template<typename T>
+typename std::enable_if<!std::is_reference<T>::value && !std::is_const<T>::value
+	&& is_wrapped_class<T>::value, typename convert<T>::to_type>::type
+to_v8(v8::Isolate* isolate, T&& value)
+{
+	return convert<T>::to_v8(isolate, std::move(value));
+}
+
+namespace detail {
+
+// Array length known before conversion for forward iterators
+template<typename Iterator>
+int array_length(Iterator begin, Iterator end, std::forward_iterator_tag)
+{
+	return static_cast<int>(std::distance(begin, end));
+}
+
+template<typename Iterator>
+int array_length(Iterator, Iterator, std::input_iterator_tag)
+{
+	return 0;
+}
+
+} // namespace detail
+
 template<typename Iterator>
 v8::Handle<v8::Array> to_v8(v8::Isolate* isolate, Iterator begin, Iterator end)
 {
 	v8::EscapableHandleScope scope(isolate);
 
-	v8::Local<v8::Array> result = v8::Array::New(isolate);
+	v8::Local<v8::Array> result = v8::Array::New(isolate, detail::array_length(begin, end,
+		typename std::iterator_traits<Iterator>::iterator_category()));
 	for (uint32_t idx = 0; begin != end; ++begin, ++idx)
 	{
 		result->Set(idx, to_v8(isolate, *begin));
@@ -777,4 +879,8 @@ v8::Local<T> to_local(v8::Isolate* isolate, v8::PersistentBase<T> const& handle)
 
 } // namespace v8pp
 
+// definition of detail::v8_function_stub used by the Function conversion,
+// it needs call_v8.hpp which depends on this header
+#include "v8pp/any_object_hidden.h"
+
 #endif // V8PP_CONVERT_HPP_INCLUDED
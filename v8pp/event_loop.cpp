@@ -0,0 +1,247 @@
+#include "v8pp/event_loop.hpp"
+
+#include <algorithm>
+
+namespace v8pp {
+
+std::chrono::milliseconds::rep const event_loop::max_delay;
+
+event_loop::event_loop(v8::Isolate* isolate)
+	: isolate_(isolate)
+	, stopped_(false)
+	, next_timer_id_(0)
+{
+}
+
+event_loop::~event_loop()
+{
+	clear();
+}
+
+void event_loop::post(task t)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		tasks_.emplace_back(std::move(t));
+	}
+	wakeup_.notify_one();
+}
+
+event_loop::timer_id event_loop::set_timer(task t, std::chrono::milliseconds delay, bool repeat)
+{
+	if (delay.count() < 0)
+	{
+		delay = std::chrono::milliseconds::zero();
+	}
+	else if (delay.count() > max_delay)
+	{
+		// clock::now() + delay should not overflow
+		delay = std::chrono::milliseconds(max_delay);
+	}
+	// a zero interval would starve posted tasks
+	clock::duration const interval = std::max<clock::duration>(delay, std::chrono::milliseconds(1));
+
+	timer_id id;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+
+		// timer ids are positive, JavaScript code tests them for truth
+		id = ++next_timer_id_;
+		if (id == 0)
+		{
+			id = ++next_timer_id_;
+		}
+
+		timer& tm = timers_[id];
+		tm.callback = std::move(t);
+		tm.interval = interval;
+		tm.repeat = repeat;
+
+		timer_entry const entry = { clock::now() + delay, id };
+		timer_heap_.push_back(entry);
+		std::push_heap(timer_heap_.begin(), timer_heap_.end(), std::greater<timer_entry>());
+	}
+	wakeup_.notify_one();
+	return id;
+}
+
+bool event_loop::clear_timer(timer_id id)
+{
+	// the heap entry stays until it reaches the top, see drop_cleared_timers()
+	std::lock_guard<std::mutex> lock(mutex_);
+	return timers_.erase(id) != 0;
+}
+
+void event_loop::drop_cleared_timers()
+{
+	while (!timer_heap_.empty() && timers_.find(timer_heap_.front().id) == timers_.end())
+	{
+		std::pop_heap(timer_heap_.begin(), timer_heap_.end(), std::greater<timer_entry>());
+		timer_heap_.pop_back();
+	}
+}
+
+void event_loop::run_microtasks()
+{
+	if (isolate_)
+	{
+		isolate_->RunMicrotasks();
+	}
+}
+
+void event_loop::set_explicit_microtasks(bool value)
+{
+	if (isolate_)
+	{
+		isolate_->SetAutorunMicrotasks(!value);
+	}
+}
+
+size_t event_loop::run_pending()
+{
+	size_t count = 0;
+
+	// tasks posted while running the batch wait for the next pass
+	std::deque<task> batch;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		batch.swap(tasks_);
+	}
+	for (task& t : batch)
+	{
+		t();
+		run_microtasks();
+		++count;
+	}
+
+	// timers expired before the pass, so a zero delay timer
+	// re-armed by its callback doesn't spin the loop
+	clock::time_point const now = clock::now();
+	for (;;)
+	{
+		task t;
+		{
+			std::lock_guard<std::mutex> lock(mutex_);
+			drop_cleared_timers();
+			if (timer_heap_.empty() || timer_heap_.front().due > now)
+			{
+				break;
+			}
+
+			std::pop_heap(timer_heap_.begin(), timer_heap_.end(), std::greater<timer_entry>());
+			timer_entry entry = timer_heap_.back();
+			timer_heap_.pop_back();
+
+			auto it = timers_.find(entry.id);
+			if (it->second.repeat)
+			{
+				t = it->second.callback;
+				entry.due = std::max(entry.due + it->second.interval, now);
+				timer_heap_.push_back(entry);
+				std::push_heap(timer_heap_.begin(), timer_heap_.end(), std::greater<timer_entry>());
+			}
+			else
+			{
+				t = std::move(it->second.callback);
+				timers_.erase(it);
+			}
+		}
+		t();
+		run_microtasks();
+		++count;
+	}
+	return count;
+}
+
+void event_loop::run(clock::time_point const* deadline)
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopped_ = false;
+	}
+
+	for (;;)
+	{
+		run_pending();
+
+		std::unique_lock<std::mutex> lock(mutex_);
+		if (stopped_)
+		{
+			break;
+		}
+		if (!tasks_.empty())
+		{
+			continue;
+		}
+
+		drop_cleared_timers();
+		bool const has_timers = !timer_heap_.empty();
+		if (!deadline && !has_timers)
+		{
+			// idle: nothing is able to post a new task from the loop thread
+			break;
+		}
+
+		clock::time_point wake_time;
+		if (deadline)
+		{
+			if (clock::now() >= *deadline)
+			{
+				break;
+			}
+			wake_time = *deadline;
+			if (has_timers && timer_heap_.front().due < wake_time)
+			{
+				wake_time = timer_heap_.front().due;
+			}
+		}
+		else
+		{
+			wake_time = timer_heap_.front().due;
+		}
+
+		// post(), set_timer() and stop() notify to wake up earlier
+		wakeup_.wait_until(lock, wake_time);
+	}
+}
+
+void event_loop::run_until_idle()
+{
+	run(nullptr);
+}
+
+void event_loop::run_for(clock::duration duration)
+{
+	clock::time_point const deadline = clock::now() + duration;
+	run(&deadline);
+}
+
+void event_loop::stop()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopped_ = true;
+	}
+	wakeup_.notify_all();
+}
+
+bool event_loop::empty() const
+{
+	std::lock_guard<std::mutex> lock(mutex_);
+	return tasks_.empty() && timers_.empty();
+}
+
+void event_loop::clear()
+{
+	// destroy callbacks outside of the lock, they may own V8 handles
+	std::deque<task> tasks;
+	std::unordered_map<timer_id, timer> timers;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		tasks.swap(tasks_);
+		timers.swap(timers_);
+		timer_heap_.clear();
+	}
+}
+
+} // namespace v8pp
@@ -0,0 +1,115 @@
+#ifndef V8PP_EVENT_LOOP_HPP_INCLUDED
+#define V8PP_EVENT_LOOP_HPP_INCLUDED
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+#include <v8.h>
+
+namespace v8pp {
+
+/// Task queue, timer heap and microtask pump for an isolate.
+/// Tasks and timers are executed on the thread that runs the loop,
+/// post(), set_timer(), clear_timer() and stop() may be called from any thread.
+class event_loop
+{
+public:
+	using clock = std::chrono::steady_clock;
+	using task = std::function<void()>;
+	using timer_id = uint32_t;
+
+	explicit event_loop(v8::Isolate* isolate);
+	~event_loop();
+
+	event_loop(event_loop const&) = delete;
+	event_loop& operator=(event_loop const&) = delete;
+
+	/// V8 isolate used for microtask checkpoints
+	v8::Isolate* isolate() { return isolate_; }
+
+	/// Post a task to run on the loop thread
+	void post(task t);
+
+	/// Longest timer delay in milliseconds, 2^31-1 as for JavaScript timers
+	static std::chrono::milliseconds::rep const max_delay = 0x7fffffff;
+
+	/// Run a task after the delay, every delay if repeat is set.
+	/// A delay longer than max_delay is clamped.
+	/// Returns id of the timer for clear_timer()
+	timer_id set_timer(task t, std::chrono::milliseconds delay, bool repeat = false);
+
+	/// Cancel a timer, returns false if the timer has already fired or was cleared
+	bool clear_timer(timer_id id);
+
+	/// Run pending microtasks. A checkpoint is made after each task and timer.
+	void run_microtasks();
+
+	/// Disable automatic microtask runs at the end of each script,
+	/// microtasks run only on checkpoints made by the loop
+	void set_explicit_microtasks(bool value);
+
+	/// Run posted tasks and expired timers without waiting
+	/// Returns number of executed tasks
+	size_t run_pending();
+
+	/// Run until there are no posted tasks and no active timers, or stop() was called
+	void run_until_idle();
+
+	/// Run for the duration, or until stop() was called
+	void run_for(clock::duration duration);
+
+	/// Make run_until_idle() or run_for() return after the current task
+	void stop();
+
+	/// No posted tasks and no active timers
+	bool empty() const;
+
+	/// Drop all posted tasks and timers
+	void clear();
+
+private:
+	struct timer
+	{
+		task callback;
+		clock::duration interval;
+		bool repeat;
+	};
+
+	struct timer_entry
+	{
+		clock::time_point due;
+		timer_id id;
+
+		bool operator>(timer_entry const& other) const
+		{
+			return due > other.due || (due == other.due && id > other.id);
+		}
+	};
+
+	void run(clock::time_point const* deadline);
+
+	/// Remove cleared timers from the heap top, mutex_ must be locked
+	void drop_cleared_timers();
+
+	v8::Isolate* isolate_;
+
+	mutable std::mutex mutex_;
+	std::condition_variable wakeup_;
+	bool stopped_;
+
+	std::deque<task> tasks_;
+
+	timer_id next_timer_id_;
+	std::vector<timer_entry> timer_heap_;
+	std::unordered_map<timer_id, timer> timers_;
+};
+
+} // namespace v8pp
+
+#endif // V8PP_EVENT_LOOP_HPP_INCLUDED
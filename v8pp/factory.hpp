@@ -1,6 +1,7 @@
 #ifndef V8PP_FACTORY_HPP_INCLUDED
 #define V8PP_FACTORY_HPP_INCLUDED
 
+#include <type_traits>
 #include <utility>
 
 #include <v8.h>
@@ -29,6 +30,37 @@ struct factory : public ref_debug<factory<T>>
 	}
 };
 
+namespace detail {
+
+template<typename Factory>
+struct has_object_size
+{
+	template<typename U> static std::true_type test(decltype(&U::object_size));
+	template<typename U> static std::false_type test(...);
+	static bool const value = decltype(test<Factory>(nullptr))::value;
+};
+
+/// Size of T objects for external memory accounting:
+/// factory<T>::object_size, or sizeof(T) for factories without it
+template<typename T, bool = has_object_size<factory<T>>::value>
+struct object_size : std::integral_constant<size_t, factory<T>::object_size>
+{
+};
+
+template<typename T>
+struct object_size<T, false> : std::integral_constant<size_t, sizeof(T)>
+{
+};
+
+} // namespace detail
+
+/// Specialize as std::true_type for classes with destructor
+/// safe to run on another thread, required by destroy_background policy
+template<typename T>
+struct thread_safe_destructible : std::false_type
+{
+};
+
 } //namespace v8pp
 
 #endif // V8PP_FACTORY_HPP_INCLUDED
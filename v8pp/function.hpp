@@ -6,6 +6,7 @@
 #include <type_traits>
 
 #include "v8pp/call_from_v8.hpp"
+#include "v8pp/profiler.hpp"
 #include "v8pp/throw_ex.hpp"
 #include "v8pp/utility.hpp"
 #include "v8pp/external_type_data.h"
@@ -108,7 +109,24 @@ namespace v8pp {
 			return *data;
 		}
 
-		template<typename F>
+		template<typename T>
+		T& receiver(v8::Isolate* isolate, v8::Local<v8::Object> obj, std::false_type /*trusted*/)
+		{
+			return from_v8<T&>(isolate, obj);
+		}
+
+		// Receiver checked by v8::Signature of the class template
+		template<typename T>
+		T& receiver(v8::Isolate* isolate, v8::Local<v8::Object> obj, std::true_type /*trusted*/)
+		{
+			if (T* object = class_<typename std::remove_cv<T>::type>::unwrap_trusted(isolate, obj))
+			{
+				return *object;
+			}
+			throw std::runtime_error("expected C++ wrapped object");
+		}
+
+		template<typename F, bool Trusted = false>
 		typename std::enable_if<is_function_pointer<F>::value || is_std_function<F>::value,
 			typename function_traits<F>::return_type>::type
 			invoke(v8::FunctionCallbackInfo<v8::Value> const& args)
@@ -117,7 +135,7 @@ namespace v8pp {
 			return call_from_v8(std::forward<F>(f), args);
 		}
 
-		template<typename F>
+		template<typename F, bool Trusted = false>
 		typename std::enable_if<std::is_member_function_pointer<F>::value,
 			typename function_traits<F>::return_type>::type
 			invoke(v8::FunctionCallbackInfo<v8::Value> const& args)
@@ -127,24 +145,24 @@ namespace v8pp {
 			using class_type = typename std::tuple_element<0, arguments>::type;
 
 			F f = get_external_data<F>(args.Data());
-			class_type& obj = from_v8<class_type&>(args.GetIsolate(), args.This());
+			class_type& obj = receiver<class_type>(args.GetIsolate(), args.This(), std::integral_constant<bool, Trusted>());
 
 			return call_from_v8(obj, std::forward<F>(f), args);
 		}
 
-		template<typename F>
+		template<typename F, bool Trusted = false>
 		typename std::enable_if<is_void_return<F>::value>::type
 			forward_ret(v8::FunctionCallbackInfo<v8::Value> const& args, return_empty e_type = NONE)
 		{
-			invoke<F>(args);
+			invoke<F, Trusted>(args);
 		}
 
-		template<typename F>
+		template<typename F, bool Trusted = false>
 		typename std::enable_if<is_pointer_return<F>::value &&
 			!is_string_pointer_return<F>::value>::type
 			forward_ret(v8::FunctionCallbackInfo<v8::Value> const& args, return_empty e_type = NONE)
 		{
-			typename function_traits<F>::return_type ret = invoke<F>(args);
+			typename function_traits<F>::return_type ret = invoke<F, Trusted>(args);
 			if (ret == nullptr)
 				if ((e_type == SET_NULL) || (e_type == NONE))
 					args.GetReturnValue().SetNull();
@@ -154,11 +172,11 @@ namespace v8pp {
 				args.GetReturnValue().Set(to_v8(args.GetIsolate(), ret));
 		}
 
-		template<typename F>
+		template<typename F, bool Trusted = false>
 		typename std::enable_if<is_string_pointer_return<F>::value>::type
 		forward_ret(v8::FunctionCallbackInfo<v8::Value> const& args, return_empty e_type = NONE)
 		{
-			typename function_traits<F>::return_type ret = invoke<F>(args);
+			typename function_traits<F>::return_type ret = invoke<F, Trusted>(args);
 			if (ret == nullptr)
 				if (e_type == SET_NULL)
 					args.GetReturnValue().SetNull();
@@ -170,23 +188,23 @@ namespace v8pp {
 				args.GetReturnValue().Set(to_v8(args.GetIsolate(), *ret));
 		}
 
-		template<typename F>
+		template<typename F, bool Trusted = false>
 		typename std::enable_if < !is_pointer_return<F>::value &&
 			!is_void_return<F>::value &&
 			!is_string_return<F>::value> ::type
 			forward_ret(v8::FunctionCallbackInfo<v8::Value> const& args, return_empty e_type = NONE)
 		{
-			args.GetReturnValue().Set(to_v8(args.GetIsolate(), invoke<F>(args)));
+			args.GetReturnValue().Set(to_v8(args.GetIsolate(), invoke<F, Trusted>(args)));
 		}
 
-		template<typename F>
+		template<typename F, bool Trusted = false>
 		typename std::enable_if < !is_pointer_return<F>::value &&
 			!is_void_return<F>::value &&
 			is_string_return<F>::value
 		> ::type
 		forward_ret(v8::FunctionCallbackInfo<v8::Value> const& args, return_empty e_type = NONE)
 		{
-			function_traits<F>::return_type ret = invoke<F>(args);
+			function_traits<F>::return_type ret = invoke<F, Trusted>(args);
 			if (ret.empty() && e_type != NONE)
 			{
 				if (e_type == SET_NULL)
@@ -198,7 +216,7 @@ namespace v8pp {
 				args.GetReturnValue().Set(to_v8(args.GetIsolate(), ret));
 		}
 
-		template<typename F>
+		template<typename F, bool Trusted = false>
 		void forward_function(v8::FunctionCallbackInfo<v8::Value> const& args)
 		{
 			static_assert(detail::is_function_pointer<F>::value
@@ -208,10 +226,11 @@ namespace v8pp {
 
 			v8::Isolate* isolate = args.GetIsolate();
 			v8::HandleScope scope(isolate);
+			V8PP_PROFILE_CALL(isolate, args.Data(), op_call);
 
 			try
 			{
-				forward_ret<F>(args);
+				forward_ret<F, Trusted>(args);
 			}
 			catch (std::exception const& ex)
 			{
@@ -219,7 +238,7 @@ namespace v8pp {
 			}
 		}
 
-		template<typename F>
+		template<typename F, bool Trusted = false>
 		void forward_function_using_null(v8::FunctionCallbackInfo<v8::Value> const& args)
 		{
 			static_assert(detail::is_function_pointer<F>::value
@@ -228,10 +247,11 @@ namespace v8pp {
 
 			v8::Isolate* isolate = args.GetIsolate();
 			v8::HandleScope scope(isolate);
+			V8PP_PROFILE_CALL(isolate, args.Data(), op_call);
 
 			try
 			{
-				forward_ret<F>(args, SET_NULL);
+				forward_ret<F, Trusted>(args, SET_NULL);
 			}
 			catch (std::exception const& ex)
 			{
@@ -239,7 +259,7 @@ namespace v8pp {
 			}
 		}
 
-		template<typename F>
+		template<typename F, bool Trusted = false>
 		void forward_function_using_undefined(v8::FunctionCallbackInfo<v8::Value> const& args)
 		{
 			static_assert(detail::is_function_pointer<F>::value
@@ -248,10 +268,11 @@ namespace v8pp {
 
 			v8::Isolate* isolate = args.GetIsolate();
 			v8::HandleScope scope(isolate);
+			V8PP_PROFILE_CALL(isolate, args.Data(), op_call);
 
 			try
 			{
-				forward_ret<F>(args, SET_UNDEFINED);
+				forward_ret<F, Trusted>(args, SET_UNDEFINED);
 			}
 			catch (std::exception const& ex)
 			{
@@ -261,19 +282,45 @@ namespace v8pp {
 
 	} // namespace detail
 
+	namespace detail {
+
+		/// New V8 function template for C++ function with data made by set_external_data()
+		template<typename F>
+		v8::Handle<v8::FunctionTemplate> function_template(v8::Isolate* isolate, v8::Handle<v8::Value> data, return_empty empty_return = NONE)
+		{
+			if (empty_return == NONE)
+				return v8::FunctionTemplate::New(isolate, &forward_function<F>, data);
+			else if (empty_return == SET_NULL)
+				return v8::FunctionTemplate::New(isolate, &forward_function_using_null<F>, data);
+			else
+				return v8::FunctionTemplate::New(isolate, &forward_function_using_undefined<F>, data);
+		}
+
+		/// New V8 function template for C++ member function with receivers
+		/// checked by V8 with the signature, unchecked if the signature is empty
+		template<typename F>
+		v8::Handle<v8::FunctionTemplate> method_template(v8::Isolate* isolate, v8::Handle<v8::Value> data,
+			v8::Handle<v8::Signature> signature, return_empty empty_return = NONE)
+		{
+			static_assert(std::is_member_function_pointer<F>::value, "required pointer to a member function");
+
+			if (signature.IsEmpty())
+				return function_template<F>(isolate, data, empty_return);
+			else if (empty_return == NONE)
+				return v8::FunctionTemplate::New(isolate, &forward_function<F, true>, data, signature);
+			else if (empty_return == SET_NULL)
+				return v8::FunctionTemplate::New(isolate, &forward_function_using_null<F, true>, data, signature);
+			else
+				return v8::FunctionTemplate::New(isolate, &forward_function_using_undefined<F, true>, data, signature);
+		}
+
+	} // namespace detail
+
 	/// Wrap C++ function into new V8 function template
 	template<typename F>
 	v8::Handle<v8::FunctionTemplate> wrap_function_template(v8::Isolate* isolate, F func, return_empty empty_return = NONE)
 	{
-		if (empty_return == NONE)
-		return v8::FunctionTemplate::New(isolate, &detail::forward_function<F>,
-			detail::set_external_data(isolate, func));
-		else if (empty_return == SET_NULL)
-			return v8::FunctionTemplate::New(isolate, &detail::forward_function_using_null<F>,
-			detail::set_external_data(isolate, func));
-		else
-			return v8::FunctionTemplate::New(isolate, &detail::forward_function_using_undefined<F>,
-			detail::set_external_data(isolate, func));
+		return detail::function_template<F>(isolate, detail::set_external_data(isolate, func), empty_return);
 	}
 
 	/// Wrap C++ function into new V8 function
@@ -282,11 +329,12 @@ namespace v8pp {
 	template<typename F>
 	v8::Handle<v8::Function> wrap_function(v8::Isolate* isolate, char const* name, F func)
 	{
-		v8::Handle<v8::Function> fn = v8::Function::New(isolate, &detail::forward_function<F>,
-			detail::set_external_data(isolate, func));
+		v8::Handle<v8::Value> data = detail::set_external_data(isolate, func);
+		v8::Handle<v8::Function> fn = v8::Function::New(isolate, &detail::forward_function<F>, data);
 		if (name && *name)
 		{
 			fn->SetName(to_v8(isolate, name));
+			V8PP_PROFILE_NAME(isolate, data, nullptr, name);
 		}
 		return fn;
 	}
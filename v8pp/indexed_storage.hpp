@@ -0,0 +1,280 @@
+#ifndef V8PP_INDEXED_STORAGE_HPP_INCLUDED
+#define V8PP_INDEXED_STORAGE_HPP_INCLUDED
+
+#include <cstdint>
+#include <type_traits>
+
+#include <v8.h>
+
+#include "v8pp/convert.hpp"
+#include "v8pp/throw_ex.hpp"
+#include "v8pp/function.hpp"
+
+namespace v8pp {
+
+template<typename T>
+class class_;
+
+namespace detail {
+
+struct element_bool_tag {};
+struct element_int32_tag {};
+struct element_uint32_tag {};
+struct element_number_tag {};
+struct element_convert_tag {};
+
+// Arithmetic elements are set to the return value without a handle allocation
+template<typename E>
+using select_element_tag = typename std::conditional<std::is_same<E, bool>::value,
+	element_bool_tag,
+	typename std::conditional<std::is_integral<E>::value && sizeof(E) <= sizeof(int32_t),
+		typename std::conditional<std::is_signed<E>::value, element_int32_tag, element_uint32_tag>::type,
+		typename std::conditional<std::is_arithmetic<E>::value, element_number_tag, element_convert_tag>::type
+	>::type
+>::type;
+
+template<typename E>
+void set_element(v8::ReturnValue<v8::Value> ret, v8::Isolate*, E value, element_bool_tag)
+{
+	ret.Set(value);
+}
+
+template<typename E>
+void set_element(v8::ReturnValue<v8::Value> ret, v8::Isolate*, E value, element_int32_tag)
+{
+	ret.Set(static_cast<int32_t>(value));
+}
+
+template<typename E>
+void set_element(v8::ReturnValue<v8::Value> ret, v8::Isolate*, E value, element_uint32_tag)
+{
+	ret.Set(static_cast<uint32_t>(value));
+}
+
+template<typename E>
+void set_element(v8::ReturnValue<v8::Value> ret, v8::Isolate*, E value, element_number_tag)
+{
+	ret.Set(static_cast<double>(value));
+}
+
+template<typename E>
+void set_element(v8::ReturnValue<v8::Value> ret, v8::Isolate* isolate, E const& value, element_convert_tag)
+{
+	ret.Set(to_v8(isolate, value));
+}
+
+/// Typed array type for an arithmetic element type
+template<typename E, typename Enable = void>
+struct typed_array;
+
+template<typename E>
+struct typed_array<E, typename std::enable_if<std::is_integral<E>::value && !std::is_same<E, bool>::value
+	&& sizeof(E) == 1>::type>
+{
+	using type = typename std::conditional<std::is_signed<E>::value, v8::Int8Array, v8::Uint8Array>::type;
+};
+
+template<typename E>
+struct typed_array<E, typename std::enable_if<std::is_integral<E>::value && sizeof(E) == 2>::type>
+{
+	using type = typename std::conditional<std::is_signed<E>::value, v8::Int16Array, v8::Uint16Array>::type;
+};
+
+template<typename E>
+struct typed_array<E, typename std::enable_if<std::is_integral<E>::value && sizeof(E) == 4>::type>
+{
+	using type = typename std::conditional<std::is_signed<E>::value, v8::Int32Array, v8::Uint32Array>::type;
+};
+
+template<typename E>
+struct typed_array<E, typename std::enable_if<std::is_same<E, float>::value>::type>
+{
+	using type = v8::Float32Array;
+};
+
+template<typename E>
+struct typed_array<E, typename std::enable_if<std::is_same<E, double>::value>::type>
+{
+	using type = v8::Float64Array;
+};
+
+} // namespace detail
+
+/// Typed array view on contiguous arithmetic elements, without a copy.
+/// The view is valid while the elements are not moved or freed,
+/// V8 does not own the memory. A non-empty owner, usually the wrapper
+/// of the C++ object with the elements, is kept alive by the view.
+template<typename E>
+v8::Local<typename detail::typed_array<typename std::remove_cv<E>::type>::type>
+typed_array_view(v8::Isolate* isolate, E* data, size_t size,
+	v8::Local<v8::Object> owner = v8::Local<v8::Object>())
+{
+	using array_type = typename detail::typed_array<typename std::remove_cv<E>::type>::type;
+
+	v8::Local<v8::ArrayBuffer> buffer = v8::ArrayBuffer::New(isolate,
+		const_cast<typename std::remove_cv<E>::type*>(data), size * sizeof(E));
+	v8::Local<array_type> view = array_type::New(buffer, 0, size);
+	if (!owner.IsEmpty())
+	{
+		view->SetHiddenValue(v8pp::to_v8(isolate, "v8pp::owner"), owner);
+	}
+	return view;
+}
+
+namespace detail {
+
+/// Contiguous storage of a wrapped object: data() pointer to elements and their size()
+template<typename Data, typename Size>
+struct indexed_storage
+{
+	using class_type = typename std::tuple_element<0,
+		typename function_traits<Data>::arguments>::type;
+	using pure_class = typename remove_all<class_type>::type;
+	using pointer = typename function_traits<Data>::return_type;
+	using element_type = typename std::remove_pointer<pointer>::type;
+	using value_type = typename std::remove_cv<element_type>::type;
+
+	static_assert(std::is_pointer<pointer>::value, "storage data() must return a pointer to elements");
+	static_assert(std::is_integral<typename function_traits<Size>::return_type>::value,
+		"storage size() must return an integer");
+
+	static bool const writable = !std::is_const<element_type>::value;
+
+	Data data;
+	Size size;
+	bool read_only;
+
+	static void get(uint32_t index, v8::PropertyCallbackInfo<v8::Value> const& info)
+	{
+		v8::Isolate* isolate = info.GetIsolate();
+		pure_class* obj = class_<pure_class>::unwrap_this(isolate, info.This());
+		if (!obj)
+		{
+			return;
+		}
+
+		indexed_storage const& storage = get_external_data<indexed_storage>(info.Data());
+		if (index < static_cast<size_t>((obj->*storage.size)()))
+		{
+			set_element(info.GetReturnValue(), isolate, (obj->*storage.data)()[index],
+				select_element_tag<value_type>());
+		}
+	}
+
+	static void set(uint32_t index, v8::Local<v8::Value> value, v8::PropertyCallbackInfo<v8::Value> const& info)
+	{
+		set(index, value, info, std::integral_constant<bool, writable>());
+	}
+
+	static void query(uint32_t index, v8::PropertyCallbackInfo<v8::Integer> const& info)
+	{
+		pure_class* obj = class_<pure_class>::unwrap_this(info.GetIsolate(), info.This());
+		if (obj)
+		{
+			indexed_storage const& storage = get_external_data<indexed_storage>(info.Data());
+			if (index < static_cast<size_t>((obj->*storage.size)()))
+			{
+				bool const read_only = !writable || storage.read_only;
+				info.GetReturnValue().Set(int32_t(read_only ? v8::ReadOnly | v8::DontDelete : v8::DontDelete));
+			}
+		}
+	}
+
+	static void enumerate(v8::PropertyCallbackInfo<v8::Array> const& info)
+	{
+		v8::Isolate* isolate = info.GetIsolate();
+		pure_class* obj = class_<pure_class>::unwrap_this(isolate, info.This());
+		if (obj)
+		{
+			indexed_storage const& storage = get_external_data<indexed_storage>(info.Data());
+			uint32_t const size = static_cast<uint32_t>((obj->*storage.size)());
+			v8::Local<v8::Array> indices = v8::Array::New(isolate, static_cast<int>(size));
+			for (uint32_t i = 0; i < size; ++i)
+			{
+				indices->Set(i, v8::Integer::NewFromUnsigned(isolate, i));
+			}
+			info.GetReturnValue().Set(indices);
+		}
+	}
+
+	/// Getter of a typed array view on the storage. The view keeps
+	/// the object wrapper alive and is cached in the wrapper by the property
+	/// name until the storage is moved or resized
+	static void get_view(v8::Local<v8::String> name, v8::PropertyCallbackInfo<v8::Value> const& info)
+	{
+		v8::Isolate* isolate = info.GetIsolate();
+		v8::Local<v8::Object> self = info.This();
+		pure_class* obj = class_<pure_class>::unwrap_this(isolate, self);
+		if (!obj)
+		{
+			return;
+		}
+
+		indexed_storage const& storage = get_external_data<indexed_storage>(info.Data());
+		element_type* data = (obj->*storage.data)();
+		size_t const size = static_cast<size_t>((obj->*storage.size)());
+
+		v8::Local<v8::Value> cached = self->GetHiddenValue(name);
+		if (!cached.IsEmpty() && cached->IsTypedArray())
+		{
+			v8::Local<v8::TypedArray> view = cached.As<v8::TypedArray>();
+			if (view->Length() == size && view->Buffer()->GetContents().Data() == data)
+			{
+				info.GetReturnValue().Set(view);
+				return;
+			}
+		}
+
+		v8::Local<v8::TypedArray> view = typed_array_view(isolate, data, size, self);
+		self->SetHiddenValue(name, view);
+		info.GetReturnValue().Set(view);
+	}
+
+private:
+	static void set(uint32_t index, v8::Local<v8::Value> value, v8::PropertyCallbackInfo<v8::Value> const& info, std::true_type /*writable*/)
+	{
+		v8::Isolate* isolate = info.GetIsolate();
+		pure_class* obj = class_<pure_class>::unwrap_this(isolate, info.This());
+		if (!obj)
+		{
+			return;
+		}
+
+		indexed_storage const& storage = get_external_data<indexed_storage>(info.Data());
+		if (index < static_cast<size_t>((obj->*storage.size)()))
+		{
+			// assignment to a read-only element is intercepted and ignored
+			try
+			{
+				if (!storage.read_only)
+				{
+					(obj->*storage.data)()[index] = from_v8<value_type>(isolate, value);
+				}
+				info.GetReturnValue().Set(value);
+			}
+			catch (std::exception const& ex)
+			{
+				info.GetReturnValue().Set(throw_ex(isolate, ex.what()));
+			}
+		}
+	}
+
+	static void set(uint32_t index, v8::Local<v8::Value> value, v8::PropertyCallbackInfo<v8::Value> const& info, std::false_type /*writable*/)
+	{
+		pure_class* obj = class_<pure_class>::unwrap_this(info.GetIsolate(), info.This());
+		if (obj)
+		{
+			indexed_storage const& storage = get_external_data<indexed_storage>(info.Data());
+			if (index < static_cast<size_t>((obj->*storage.size)()))
+			{
+				info.GetReturnValue().Set(value);
+			}
+		}
+	}
+};
+
+} // namespace detail
+
+} // namespace v8pp
+
+#endif // V8PP_INDEXED_STORAGE_HPP_INCLUDED
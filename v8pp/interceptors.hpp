@@ -10,9 +10,97 @@
 
 namespace v8pp
 {
+	/// Keys of an interceptor enumerator `void enumerate(v8pp::enum_sink& keys)`,
+	/// written directly into the result array without an intermediate container
+	class enum_sink
+	{
+	public:
+		explicit enum_sink(v8::Isolate* isolate)
+			: isolate_(isolate)
+			, size_(0)
+			, capacity_(0)
+		{
+		}
+
+		enum_sink(enum_sink const&) = delete;
+		enum_sink& operator=(enum_sink const&) = delete;
+
+		v8::Isolate* isolate() const { return isolate_; }
+
+		/// Number of added keys
+		uint32_t size() const { return size_; }
+
+		/// Expected number of keys, allocates the result array once.
+		/// Should be called before the first key is added.
+		void reserve(uint32_t capacity)
+		{
+			if (keys_.IsEmpty())
+			{
+				keys_ = v8::Array::New(isolate_, static_cast<int>(capacity));
+				capacity_ = capacity;
+			}
+		}
+
+		/// Add a property name, internalized as V8 does for property keys
+		void add(string_view name)
+		{
+			add(v8::String::NewFromUtf8(isolate_, name.data(),
+				v8::String::kInternalizedString, static_cast<int>(name.size())));
+		}
+
+		void add(char const* name)
+		{
+			add(string_view(name, std::char_traits<char>::length(name)));
+		}
+
+		/// Add a property index
+		void add(uint32_t index)
+		{
+			add(v8::Integer::NewFromUnsigned(isolate_, index));
+		}
+
+		/// Add a key value as is, e.g. a cached V8 string
+		void add(v8::Local<v8::Value> key)
+		{
+			if (keys_.IsEmpty())
+			{
+				keys_ = v8::Array::New(isolate_);
+			}
+			keys_->Set(size_++, key);
+		}
+
+		/// Array of added keys
+		v8::Local<v8::Array> keys()
+		{
+			if (keys_.IsEmpty())
+			{
+				keys_ = v8::Array::New(isolate_);
+			}
+			else if (size_ < capacity_)
+			{
+				keys_->Set(v8pp::to_v8(isolate_, "length"), v8::Integer::NewFromUnsigned(isolate_, size_));
+			}
+			return keys_;
+		}
+
+	private:
+		v8::Isolate* isolate_;
+		v8::Local<v8::Array> keys_;
+		uint32_t size_;
+		uint32_t capacity_;
+	};
+
 	namespace detail {
 		struct query_bool_return{};
 
+		template<typename F, bool = call_from_v8_traits<F>::arg_count == 1>
+		struct is_sink_enumer : std::false_type {};
+
+		template<typename F>
+		struct is_sink_enumer<F, true> : std::integral_constant<bool,
+			is_void_return<F>::value &&
+			std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, enum_sink&>::value> {};
+
 		template <typename F>
 		using is_bool_return = std::integral_constant<bool,
 			call_from_v8_traits<F>::arg_count == 1 &&
@@ -25,23 +113,62 @@ namespace v8pp
 				query_bool_return
 		>::type;
 
+		/// Interceptor handler argument for a property index or name
+		template<typename T, typename Key>
+		struct property_key;
 
+		template<typename T>
+		struct property_key<T, uint32_t>
+		{
+			uint32_t value;
 
-		namespace property_helpers
+			property_key(uint32_t index, v8::Isolate*)
+				: value(index)
+			{
+			}
+		};
+
+		template<typename T>
+		struct property_key<T, v8::Local<v8::String>>
 		{
-			template<typename ret_type, typename pure_arg = remove_all<ret_type>::type>
-			static convertible_string<pure_arg> get_c_type(v8::Local<v8::String> &name, v8::Isolate *isolate)
+			using value_type = typename std::decay<T>::type;
+
+			typename convert<value_type>::from_type value;
+
+			property_key(v8::Local<v8::String> name, v8::Isolate* isolate)
+				: value(v8pp::from_v8<value_type>(isolate, name))
 			{
-				return v8pp::from_v8<ret_type>(isolate, name);
 			}
+		};
+
+		/// Property name borrowed as string_view, short names are
+		/// written to a buffer on stack without memory allocation
+		template<>
+		struct property_key<string_view, v8::Local<v8::String>>
+		{
+			static int const buffer_size = 128;
+
+			string_view value;
 
-			template<typename ret_type, typename pure_arg = remove_all<ret_type>::type>
-			static uint32_t get_c_type(uint32_t &num, v8::Isolate *isolate)
+			property_key(v8::Local<v8::String> name, v8::Isolate*)
 			{
-				return num;
+				int const length = name->Utf8Length();
+				char* dest = buffer_;
+				if (length > buffer_size)
+				{
+					long_name_.resize(length);
+					dest = &long_name_[0];
+				}
+				name->WriteUtf8(dest, length, nullptr, v8::String::NO_NULL_TERMINATION);
+				value = string_view(dest, length);
 			}
 
+			property_key(property_key const&) = delete;
+			property_key& operator=(property_key const&) = delete;
 
+		private:
+			char buffer_[buffer_size];
+			std::string long_name_;
 		};
 
 		template<typename method>
@@ -129,7 +256,8 @@ namespace v8pp
 			{
 				v8::Isolate* isolate = info.GetIsolate();
 				using value_type = typename call_from_v8_traits<Get>::template arg_type<0>;
-				typename function_traits<Get>::return_type ret = (obj.*get)(v8pp::from_v8<value_type>(isolate, name));
+				property_key<value_type, v8::Local<v8::String>> key(name, isolate);
+				typename function_traits<Get>::return_type ret = (obj.*get)(key.value);
 				if (ret == nullptr)
 				{
 					if ((return_handle == NONE) || (return_handle == SET_NULL))
@@ -150,7 +278,8 @@ namespace v8pp
 			{
 				v8::Isolate* isolate = info.GetIsolate();
 				using value_type = typename call_from_v8_traits<Get>::template arg_type<0>;
-				info.GetReturnValue().Set(to_v8(isolate, (obj.*get)(v8pp::from_v8<value_type>(isolate, name))));
+				property_key<value_type, v8::Local<v8::String>> key(name, isolate);
+				info.GetReturnValue().Set(to_v8(isolate, (obj.*get)(key.value)));
 			}
 
 			//named interceptor with string return
@@ -162,7 +291,8 @@ namespace v8pp
 			{
 				v8::Isolate* isolate = info.GetIsolate();
 				using value_type = typename call_from_v8_traits<Get>::template arg_type<0>;
-				typename function_traits<Get>::return_type ret = (obj.*get)(v8pp::from_v8<value_type>(isolate, name));
+				property_key<value_type, v8::Local<v8::String>> key(name, isolate);
+				typename function_traits<Get>::return_type ret = (obj.*get)(key.value);
 				if (ret == nullptr)
 				{
 					if (return_handle == NONE)
@@ -260,9 +390,9 @@ namespace v8pp
 				using arg1 = typename call_from_v8_traits<Set>::template arg_type<1>;
 
 				v8::Isolate* isolate = info.GetIsolate();
-				auto param0 = property_helpers::get_c_type<arg0>(index_name, isolate);
+				property_key<arg0, Index_or_name> key(index_name, isolate);
 
-				(obj.*set)(param0, v8pp::from_v8<arg1>(isolate, value));
+				(obj.*set)(key.value, v8pp::from_v8<arg1>(isolate, value));
 			}
 		};
 
@@ -274,10 +404,15 @@ namespace v8pp
 		template<typename Enum>
 		struct enum_handlers : public handler_types<Enum>
 		{
-			static_assert(is_enumer<Enum>::value,
-				"Enumeration hanndler must be `container<type> Enum_function()`");
+			static_assert(is_enumer<Enum>::value || is_sink_enumer<Enum>::value,
+				"Enumeration hanndler must be `container<type> Enum_function()` or `void Enum_function(v8pp::enum_sink&)`");
 
 			static void enum_impl(class_type& obj, Enum enumer, const v8::PropertyCallbackInfo<v8::Array>& info)
+			{
+				enum_impl(obj, enumer, info, is_sink_enumer<Enum>());
+			}
+
+			static void enum_impl(class_type& obj, Enum enumer, const v8::PropertyCallbackInfo<v8::Array>& info, std::false_type /*is_sink_enumer*/)
 			{
 				using value_type = typename function_traits<Enum>::return_type;
 
@@ -286,6 +421,13 @@ namespace v8pp
 
 				info.GetReturnValue().Set(v8pp::to_v8(isolate, c_ret.begin(), c_ret.end()));
 			}
+
+			static void enum_impl(class_type& obj, Enum enumer, const v8::PropertyCallbackInfo<v8::Array>& info, std::true_type /*is_sink_enumer*/)
+			{
+				enum_sink keys(info.GetIsolate());
+				(obj.*enumer)(keys);
+				info.GetReturnValue().Set(keys.keys());
+			}
 		};
 
 		template<typename Query>
@@ -299,7 +441,8 @@ namespace v8pp
 			{
 				v8::Isolate* isolate = info.GetIsolate();
 				using value_type = typename call_from_v8_traits<Query>::template arg_type<0>;
-				typename function_traits<Query>::return_type ret = (obj.*get)(property_helpers::get_c_type<value_type>(name, info.GetIsolate()));
+				property_key<value_type, Index_or_name> key(name, isolate);
+				typename function_traits<Query>::return_type ret = (obj.*get)(key.value);
 				if (ret != nullptr)
 					info.GetReturnValue().Set(int32_t(v8::None));
 			}
@@ -311,7 +454,8 @@ namespace v8pp
 			{
 				v8::Isolate* isolate = info.GetIsolate();
 				using value_type = typename call_from_v8_traits<Query>::template arg_type<0>;
-				bool ret = (obj.*get)(property_helpers::get_c_type<value_type>(name, info.GetIsolate()));
+				property_key<value_type, Index_or_name> key(name, isolate);
+				bool ret = (obj.*get)(key.value);
 				if (ret)
 					info.GetReturnValue().Set(int32_t(v8::None));
 			}
@@ -328,7 +472,8 @@ namespace v8pp
 			{
 				v8::Isolate* isolate = info.GetIsolate();
 				using value_type = typename call_from_v8_traits<Del>::template arg_type<0>;
-				bool ret = (obj.*get)(property_helpers::get_c_type<value_type>(name, isolate));
+				property_key<value_type, Index_or_name> key(name, isolate);
+				bool ret = (obj.*get)(key.value);
 				if (ret)
 					info.GetReturnValue().Set(ret);
 			}
@@ -404,10 +549,11 @@ namespace v8pp
 		static typename std::enable_if<!std::is_same<U, bool>::value>::type propertyEnumerator(const v8::PropertyCallbackInfo<v8::Array>& info)
 		{
 			v8::Isolate* isolate = info.GetIsolate();
+			V8PP_PROFILE_CALL(isolate, info.Data(), op_enumerate);
 
-			pure_class* obj = v8pp::class_<pure_class>::unwrap_object(isolate, info.This());
+			pure_class* obj = v8pp::class_<pure_class>::unwrap_this(isolate, info.This());
 
-			Indexed_Data prop = detail::get_external_data<Indexed_Data>(info.Data());
+			Indexed_Data const& prop = detail::get_external_data<Indexed_Data>(info.Data());
 			assert(prop.enum_);
 
 			if (prop.enum_)
@@ -430,8 +576,10 @@ namespace v8pp
 		static typename std::enable_if<!std::is_same<U, bool>::value>::type propertySetter(Index_or_name index, v8::Local<v8::Value> value, const v8::PropertyCallbackInfo<v8::Value>& info)
 		{
 			v8::Isolate* isolate = info.GetIsolate();
+			V8PP_PROFILE_CALL(isolate, info.Data(), op_set);
+
 			//using pure_class_type = typename detail::remove_all<class_type>::type;
-			pure_class* obj = v8pp::class_<pure_class>::unwrap_object(isolate, info.This());
+			pure_class* obj = v8pp::class_<pure_class>::unwrap_this(isolate, info.This());
 
 			if (obj == nullptr)
 			{
@@ -440,7 +588,7 @@ namespace v8pp
 					return;
 			}
 
-			Indexed_Data prop = detail::get_external_data<Indexed_Data>(info.Data());
+			Indexed_Data const& prop = detail::get_external_data<Indexed_Data>(info.Data());
 			assert(prop.set_);
 
 			if (prop.set_)
@@ -463,21 +611,40 @@ namespace v8pp
 		template<typename U = Get>
 		static typename std::enable_if<!std::is_same<U, bool>::value>::type propertyGetter(Index_or_name index, const v8::PropertyCallbackInfo<v8::Value>& info)
 		{
-			v8::Isolate* isolate = info.GetIsolate();
+			if (get_property(index, info))
+			{
+				promote_key(index, info);
+			}
+		}
 
-			pure_class* obj = v8pp::class_<pure_class>::unwrap_object(isolate, info.This());
+		/// Getter of a promoted key, the interceptor getter without hit counting
+		static void promotedGetter(v8::Local<v8::String> name, const v8::PropertyCallbackInfo<v8::Value>& info)
+		{
+			get_property(name, info);
+		}
 
-			Indexed_Data data = detail::get_external_data<Indexed_Data>(info.Data());
-			assert(data.get_);
+		/// Setter of a promoted key for `void set(key, value)` interceptor setter
+		static void promotedSetter(v8::Local<v8::String> name, v8::Local<v8::Value> value, const v8::PropertyCallbackInfo<void>& info)
+		{
+			using arg0 = typename detail::call_from_v8_traits<Set>::template arg_type<0>;
+			using arg1 = typename detail::call_from_v8_traits<Set>::template arg_type<1>;
 
-			if (data.get_)
+			v8::Isolate* isolate = info.GetIsolate();
+			V8PP_PROFILE_CALL(isolate, info.Data(), op_set);
+
+			pure_class* obj = v8pp::class_<pure_class>::unwrap_this(isolate, info.This());
+			if (obj == nullptr)
+				return;
+
+			Indexed_Data const& prop = detail::get_external_data<Indexed_Data>(info.Data());
 			try
 			{
-				detail::get_handlers<Get>::get_impl(*obj, data.get_, index, info, detail::select_getter_tag<Get>(), data.r_type);
+				detail::property_key<arg0, v8::Local<v8::String>> key(name, isolate);
+				((*obj).*prop.set_)(key.value, v8pp::from_v8<arg1>(isolate, value));
 			}
 			catch (std::exception const& ex)
 			{
-				info.GetReturnValue().Set(throw_ex(isolate, ex.what()));
+				throw_ex(isolate, ex.what());
 			}
 		}
 
@@ -490,10 +657,11 @@ namespace v8pp
 		static typename std::enable_if<!std::is_same<U, bool>::value>::type propertyQuery(Index_or_name index, const v8::PropertyCallbackInfo<v8::Integer>& info)
 		{
 			v8::Isolate* isolate = info.GetIsolate();
+			V8PP_PROFILE_CALL(isolate, info.Data(), op_query);
 
-			pure_class* obj = v8pp::class_<pure_class>::unwrap_object(isolate, info.This());
+			pure_class* obj = v8pp::class_<pure_class>::unwrap_this(isolate, info.This());
 
-			Indexed_Data data = detail::get_external_data<Indexed_Data>(info.Data());
+			Indexed_Data const& data = detail::get_external_data<Indexed_Data>(info.Data());
 			assert(data.query_);
 
 			if (data.query_)
@@ -516,10 +684,11 @@ namespace v8pp
 		static typename std::enable_if<!std::is_same<U, bool>::value>::type propertyDel(Index_or_name index, const v8::PropertyCallbackInfo<v8::Boolean>& info)
 		{
 			v8::Isolate* isolate = info.GetIsolate();
+			V8PP_PROFILE_CALL(isolate, info.Data(), op_delete);
 
-			pure_class* obj = v8pp::class_<pure_class>::unwrap_object(isolate, info.This());
+			pure_class* obj = v8pp::class_<pure_class>::unwrap_this(isolate, info.This());
 
-			Indexed_Data data = detail::get_external_data<Indexed_Data>(info.Data());
+			Indexed_Data const& data = detail::get_external_data<Indexed_Data>(info.Data());
 			assert(data.del_);
 
 			if (data.del_)
@@ -533,7 +702,82 @@ namespace v8pp
 			}
 		}
 
+	private:
+		static bool get_property(Index_or_name index, const v8::PropertyCallbackInfo<v8::Value>& info)
+		{
+			v8::Isolate* isolate = info.GetIsolate();
+			V8PP_PROFILE_CALL(isolate, info.Data(), op_get);
+
+			pure_class* obj = v8pp::class_<pure_class>::unwrap_this(isolate, info.This());
+
+			Indexed_Data const& data = detail::get_external_data<Indexed_Data>(info.Data());
+			assert(data.get_);
+
+			if (data.get_)
+			try
+			{
+				detail::get_handlers<Get>::get_impl(*obj, data.get_, index, info, detail::select_getter_tag<Get>(), data.r_type);
+				return true;
+			}
+			catch (std::exception const& ex)
+			{
+				info.GetReturnValue().Set(throw_ex(isolate, ex.what()));
+			}
+			return false;
+		}
 
+		// Keys of indexed interceptors are not promoted
+		static void promote_key(uint32_t, const v8::PropertyCallbackInfo<v8::Value>&)
+		{
+		}
+
+		// Install own accessor for a hot stable key, kNonMasking interceptor
+		// is not called for it anymore. Prototype interceptors are not promoted.
+		static void promote_key(v8::Local<v8::String> name, const v8::PropertyCallbackInfo<v8::Value>& info)
+		{
+			if (promotable() && info.This() == info.Holder()
+				&& v8pp::class_<pure_class>::count_key_hit(info.GetIsolate(), name))
+			{
+				info.Holder()->SetAccessor(name, &promotedGetter, promoted_setter(), info.Data(), v8::DEFAULT, v8::None);
+			}
+		}
+
+		// Keys of a read-only interceptor are not promoted: an accessor without
+		// setter would drop assignments that create own properties now
+		template<typename U = Set>
+		static typename std::enable_if<std::is_same<U, bool>::value, bool>::type promotable()
+		{
+			return false;
+		}
+
+		template<typename U = Set>
+		static typename std::enable_if<!std::is_same<U, bool>::value, bool>::type promotable()
+		{
+			return std::is_same<detail::select_setter_intercept_tag<U>, detail::setter_interceptor_tag>::value;
+		}
+
+		template<typename U = Set>
+		static typename std::enable_if<std::is_same<U, bool>::value, v8::AccessorSetterCallback>::type promoted_setter()
+		{
+			return nullptr;
+		}
+
+		template<typename U = Set>
+		static typename std::enable_if<!std::is_same<U, bool>::value, v8::AccessorSetterCallback>::type promoted_setter()
+		{
+			return promoted_setter(detail::select_setter_intercept_tag<U>());
+		}
+
+		static v8::AccessorSetterCallback promoted_setter(detail::setter_interceptor_tag)
+		{
+			return &promotedSetter;
+		}
+
+		template<typename Tag>
+		static v8::AccessorSetterCallback promoted_setter(Tag)
+		{
+			return nullptr;
+		}
 	};
 
 
@@ -0,0 +1,56 @@
+#ifndef V8PP_LAZY_PROPERTY_HPP_INCLUDED
+#define V8PP_LAZY_PROPERTY_HPP_INCLUDED
+
+#include <exception>
+
+#include <v8.h>
+
+#include "v8pp/throw_ex.hpp"
+
+namespace v8pp { namespace detail {
+
+/// Lazy property getter. Factory::create(isolate, name, data) makes
+/// the property value on first access, then the accessor is replaced
+/// with a plain data property holding the value.
+template<typename Factory>
+void lazy_property_get(v8::Local<v8::String> name, v8::PropertyCallbackInfo<v8::Value> const& info)
+{
+	v8::Isolate* isolate = info.GetIsolate();
+	try
+	{
+		v8::Local<v8::Value> value = Factory::create(isolate, name, info.Data());
+		info.Holder()->DefineOwnProperty(isolate->GetCurrentContext(), name, value).FromMaybe(false);
+		info.GetReturnValue().Set(value);
+	}
+	catch (std::exception const& ex)
+	{
+		info.GetReturnValue().Set(throw_ex(isolate, ex.what()));
+	}
+}
+
+/// Assignment to a lazy property replaces it without creating the value
+inline void lazy_property_set(v8::Local<v8::String> name, v8::Local<v8::Value> value,
+	v8::PropertyCallbackInfo<void> const& info)
+{
+	info.Holder()->DefineOwnProperty(info.GetIsolate()->GetCurrentContext(), name, value).FromMaybe(false);
+}
+
+/// Set lazy property in an object
+template<typename Factory>
+void set_lazy_property(v8::Local<v8::Object> obj, v8::Local<v8::String> name,
+	v8::Local<v8::Value> data = v8::Local<v8::Value>())
+{
+	obj->SetAccessor(name, &lazy_property_get<Factory>, &lazy_property_set, data, v8::DEFAULT, v8::None);
+}
+
+/// Set lazy property in an object template, each instance creates own value
+template<typename Factory>
+void set_lazy_property(v8::Local<v8::ObjectTemplate> obj, v8::Local<v8::String> name,
+	v8::Local<v8::Value> data = v8::Local<v8::Value>())
+{
+	obj->SetAccessor(name, &lazy_property_get<Factory>, &lazy_property_set, data, v8::DEFAULT, v8::None);
+}
+
+}} // namespace v8pp::detail
+
+#endif // V8PP_LAZY_PROPERTY_HPP_INCLUDED
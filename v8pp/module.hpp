@@ -5,6 +5,7 @@
 
 #include "v8pp/config.hpp"
 #include "v8pp/function.hpp"
+#include "v8pp/lazy_property.hpp"
 #include "v8pp/property.hpp"
 #include "v8pp/reference_tracker.h"
 
@@ -13,25 +14,63 @@ namespace v8pp {
 template<typename T>
 class class_;
 
+namespace detail {
+template<typename T>
+struct lazy_class_function;
+
+/// Lazy module function, created without a function template
+template<typename Function>
+struct lazy_module_function
+{
+	static v8::Local<v8::Value> create(v8::Isolate* isolate, v8::Local<v8::String> name, v8::Local<v8::Value> data)
+	{
+		v8::Local<v8::Function> fn = v8::Function::New(isolate, &forward_function<Function>, data);
+		fn->SetName(name);
+		return fn;
+	}
+};
+
+/// Lazy submodule instance, the template is kept until the isolate disposal
+struct lazy_module_instance
+{
+	using object_template = v8::UniquePersistent<v8::ObjectTemplate>;
+
+	static v8::Local<v8::Value> create(v8::Isolate* isolate, v8::Local<v8::String>, v8::Local<v8::Value> data)
+	{
+		object_template const* obj = get_external_data<object_template const*>(data);
+		return to_local(isolate, *obj)->NewInstance();
+	}
+};
+
+} // namespace detail
+
 /// Module (similar to v8::ObjectTemplate)
 class module : public ref_debug<module>
 {
 public:
-	explicit module(v8::Isolate* isolate)
+	/// Create module in the isolate. Functions and submodules of a lazy
+	/// module are created in its instance on first access, then replaced
+	/// with plain data properties
+	explicit module(v8::Isolate* isolate, bool lazy = false)
 		: isolate_(isolate)
 		, obj_(v8::ObjectTemplate::New(isolate))
+		, lazy_(lazy)
 	{
 	}
 
 	explicit module(v8::Isolate* isolate, v8::Handle<v8::ObjectTemplate> obj)
 		: isolate_(isolate)
 		, obj_(obj)
+		, lazy_(false)
 	{
 	}
 
 	/// v8::Isolate where the module belongs
 	v8::Isolate* isolate() { return isolate_; }
 
+	/// Are functions and submodules created on first access
+	bool lazy() const { return lazy_; }
+
 	/// Set a V8 value in the module with specified name
 	module& set(char const* name, v8::Handle<v8::Data> value)
 	{
@@ -39,14 +78,16 @@ public:
 		return *this;
 	}
 
-	/// Set wrapped C++ class in the module with specified name
+	/// Set wrapped C++ class in the module with specified name,
+	/// the constructor function is created on first access
 	template<typename T>
 	module& set(char const* name, class_<T>& cl)
 	{
 		v8::HandleScope scope(isolate_);
 
-		cl.class_function_template()->SetClassName(v8pp::to_v8(isolate_, name));
-		return set(name, cl.js_function_template()->GetFunction());
+		cl.set_class_name(name, isolate_);
+		detail::set_lazy_property<detail::lazy_class_function<T>>(obj_, v8pp::to_v8(isolate_, name));
+		return *this;
 	}
 
 	/// Set a C++ function in the module with specified name
@@ -56,7 +97,16 @@ public:
 		module&>::type
 	set(char const* name, Function func)
 	{
-		return set(name, wrap_function_template(isolate_, func));
+		v8::HandleScope scope(isolate_);
+
+		v8::Handle<v8::Value> data = detail::set_external_data(isolate_, func);
+		V8PP_PROFILE_NAME(isolate_, data, nullptr, name);
+		if (lazy_)
+		{
+			detail::set_lazy_property<detail::lazy_module_function<Function>>(obj_, v8pp::to_v8(isolate_, name), data);
+			return *this;
+		}
+		return set(name, detail::function_template<Function>(isolate_, data));
 	}
 
 	/// Set a C++ variable in the module with specified name
@@ -78,6 +128,7 @@ public:
 		}
 
 		v8::Handle<v8::Value> data = detail::set_external_data(isolate_, &var);
+		V8PP_PROFILE_NAME(isolate_, data, nullptr, name);
 		v8::PropertyAttribute const prop_attrs = v8::PropertyAttribute(v8::DontDelete | (setter ? 0 : v8::ReadOnly));
 
 		obj_->SetAccessor(v8pp::to_v8(isolate_, name), getter, setter, data, v8::DEFAULT, prop_attrs);
@@ -102,6 +153,7 @@ public:
 		}
 
 		v8::Handle<v8::Value> data = detail::set_external_data(isolate_, prop);
+		V8PP_PROFILE_NAME(isolate_, data, nullptr, name);
 		v8::PropertyAttribute const prop_attrs = v8::PropertyAttribute(v8::DontDelete | (setter? 0 : v8::ReadOnly));
 
 		obj_->SetAccessor(v8pp::to_v8(isolate_, name), getter, setter, data, v8::DEFAULT, prop_attrs);
@@ -122,17 +174,31 @@ public:
 	/// Set another module in the module with specified name
 	module& set(char const* name, module& m)
 	{
+		if (lazy_)
+		{
+			v8::HandleScope scope(isolate_);
+
+			using object_template = detail::lazy_module_instance::object_template;
+			v8::Local<v8::Value> data = detail::external_info::emplace_data(isolate_,
+				new object_template(isolate_, m.obj_), &detail::delete_object_callback<object_template>);
+			detail::set_lazy_property<detail::lazy_module_instance>(obj_, v8pp::to_v8(isolate_, name), data);
+			return *this;
+		}
 		return set(name, m.new_instance());
 	}
 
 	/// Create a new module instance in V8
 	v8::Local<v8::Object> new_instance() { return obj_->NewInstance(); }
 
+	/// Object template of the module
+	v8::Handle<v8::ObjectTemplate> object_template() { return obj_; }
+
 private:
 	template<typename Variable>
 	static void var_get(v8::Local<v8::String>, v8::PropertyCallbackInfo<v8::Value> const& info)
 	{
 		v8::Isolate* isolate = info.GetIsolate();
+		V8PP_PROFILE_CALL(isolate, info.Data(), op_get);
 
 		Variable* var = detail::get_external_data<Variable*>(info.Data());
 		info.GetReturnValue().Set(to_v8(isolate, *var));
@@ -142,6 +208,7 @@ private:
 	static void var_set(v8::Local<v8::String>, v8::Local<v8::Value> value, v8::PropertyCallbackInfo<void> const& info)
 	{
 		v8::Isolate* isolate = info.GetIsolate();
+		V8PP_PROFILE_CALL(isolate, info.Data(), op_set);
 
 		Variable* var = detail::get_external_data<Variable*>(info.Data());
 		*var = v8pp::from_v8<Variable>(isolate, value);
@@ -149,6 +216,7 @@ private:
 
 	v8::Isolate* isolate_;
 	v8::Handle<v8::ObjectTemplate> obj_;
+	bool lazy_;
 };
 
 } // namespace v8pp
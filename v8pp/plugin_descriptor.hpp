@@ -0,0 +1,58 @@
+#ifndef V8PP_PLUGIN_DESCRIPTOR_HPP_INCLUDED
+#define V8PP_PLUGIN_DESCRIPTOR_HPP_INCLUDED
+
+#include <cstddef>
+#include <cstdint>
+
+#include <v8.h>
+#include <v8-version.h>
+
+#include "v8pp/config.hpp"
+
+namespace v8pp {
+
+/// Capabilities a plugin may require from the host
+enum plugin_capability : uint32_t
+{
+	plugin_export_table = 1 << 0, ///< functions are registered from plugin_descriptor::exports
+};
+
+/// Capabilities supported by this host
+uint32_t const plugin_host_capabilities = plugin_export_table;
+
+/// Function exported by a plugin
+struct plugin_export
+{
+	char const* name;
+	v8::FunctionCallback callback;
+	int arity;                    ///< value of the function `length` property
+};
+
+/// Static plugin description, checked by the host before the plugin is used.
+/// Layout of the structure is fixed for an ABI version.
+struct plugin_descriptor
+{
+	uint32_t abi_version;         ///< V8PP_PLUGIN_ABI_VERSION of the plugin
+	uint32_t v8_major_version;    ///< V8 headers the plugin was compiled with
+	uint32_t v8_minor_version;
+	uint32_t required_capabilities; ///< plugin_capability flags
+	char const* name;
+	plugin_export const* exports;
+	size_t export_count;
+};
+
+} // namespace v8pp
+
+/// Define descriptor of a plugin exporting a static array of v8pp::plugin_export
+#define V8PP_PLUGIN_DESCRIPTOR(plugin_name, export_table) \
+	extern "C" V8PP_EXPORT v8pp::plugin_descriptor const* V8PP_PLUGIN_DESCRIPTOR_PROC_NAME() \
+	{ \
+		static v8pp::plugin_descriptor const descriptor = \
+		{ \
+			V8PP_PLUGIN_ABI_VERSION, V8_MAJOR_VERSION, V8_MINOR_VERSION, v8pp::plugin_export_table, \
+			plugin_name, export_table, sizeof(export_table) / sizeof(export_table[0]) \
+		}; \
+		return &descriptor; \
+	}
+
+#endif // V8PP_PLUGIN_DESCRIPTOR_HPP_INCLUDED
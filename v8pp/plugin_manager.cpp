@@ -0,0 +1,324 @@
+#include "v8pp/plugin_manager.hpp"
+#include "v8pp/function.hpp"
+#include "v8pp/lazy_property.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <stdexcept>
+#include <thread>
+
+#if defined(WIN32)
+#include <windows.h>
+static char const path_sep = '\\';
+#else
+#include <dlfcn.h>
+static char const path_sep = '/';
+#endif
+
+#define STRINGIZE(s) STRINGIZE0(s)
+#define STRINGIZE0(s) #s
+
+namespace v8pp {
+
+namespace detail {
+
+/// Function of a plugin export table, created on first access
+struct lazy_plugin_function
+{
+	static v8::Local<v8::Value> create(v8::Isolate* isolate, v8::Local<v8::String> name, v8::Local<v8::Value> data)
+	{
+		plugin_export const* entry = get_external_data<plugin_export const*>(data);
+		v8::Local<v8::Function> fn = v8::Function::New(isolate, entry->callback,
+			v8::Local<v8::Value>(), entry->arity);
+		fn->SetName(name);
+		return fn;
+	}
+};
+
+} // namespace detail
+
+plugin_manager::plugin_manager(v8::Isolate* isolate)
+	: isolate_(isolate)
+	, bind_now_(false)
+{
+}
+
+plugin_manager::~plugin_manager()
+{
+	// export templates refer to the library export tables
+	for (auto& kv : export_templates_)
+	{
+		kv.second.Reset();
+	}
+	export_templates_.clear();
+
+	for (auto& kv : plugins_)
+	{
+		plugin& p = kv.second;
+		if (p.handle)
+		{
+			unload(p.handle);
+		}
+	}
+}
+
+plugin_manager& plugin_manager::instance(v8::Isolate* isolate)
+{
+	plugin_manager* result = get(isolate);
+	if (!result)
+	{
+		result = new plugin_manager(isolate);
+		isolate->SetData(V8PP_PLUGIN_MANAGER_DATA_SLOT, result);
+	}
+	return *result;
+}
+
+void plugin_manager::remove(v8::Isolate* isolate)
+{
+	delete get(isolate);
+	isolate->SetData(V8PP_PLUGIN_MANAGER_DATA_SLOT, nullptr);
+}
+
+plugin_manager::plugin& plugin_manager::declare(std::string const& name)
+{
+	auto it = plugins_.find(name);
+	if (it == plugins_.end())
+	{
+		plugin p;
+		p.name = name;
+		it = plugins_.emplace(name, p).first;
+	}
+	return it->second;
+}
+
+plugin_manager& plugin_manager::add(std::string const& name, std::vector<std::string> const& depends)
+{
+	declare(name).depends = depends;
+	return *this;
+}
+
+plugin_manager::plugin const* plugin_manager::find(std::string const& name) const
+{
+	auto it = plugins_.find(name);
+	return it != plugins_.end() ? &it->second : nullptr;
+}
+
+void plugin_manager::load(plugin& p, std::string const& lib_path, bool bind_now)
+{
+	if (p.handle)
+	{
+		return;
+	}
+
+	// failures are not cached, the library may be found in another
+	// library path or deployed after the failed attempt
+	p.error.clear();
+	p.descriptor = nullptr;
+
+	p.filename = p.name;
+	if (!lib_path.empty())
+	{
+		p.filename = lib_path + path_sep + p.name;
+	}
+	std::string const suffix = V8PP_PLUGIN_SUFFIX;
+	if (p.filename.size() >= suffix.size()
+		&& p.filename.compare(p.filename.size() - suffix.size(), suffix.size(), suffix) != 0)
+	{
+		p.filename += suffix;
+	}
+
+#if defined(WIN32)
+	// Windows resolves imports on load, there is no lazy binding to disable
+	UINT const prev_error_mode = SetErrorMode(SEM_NOOPENFILEERRORBOX);
+	void* handle = LoadLibraryA(p.filename.c_str());
+	::SetErrorMode(prev_error_mode);
+#else
+	void* handle = dlopen(p.filename.c_str(), bind_now ? RTLD_NOW : RTLD_LAZY);
+#endif
+	if (!handle)
+	{
+		p.error = "could not load shared library " + p.filename;
+#if !defined(WIN32)
+		char const* reason = dlerror();
+		if (reason)
+		{
+			p.error += std::string(": ") + reason;
+		}
+#endif
+		return;
+	}
+
+	using descriptor_proc = plugin_descriptor const*(*)();
+#if defined(WIN32)
+	void* descriptor_sym = ::GetProcAddress((HMODULE)handle, STRINGIZE(V8PP_PLUGIN_DESCRIPTOR_PROC_NAME));
+	void* init_sym = ::GetProcAddress((HMODULE)handle, STRINGIZE(V8PP_PLUGIN_INIT_PROC_NAME));
+#else
+	void* descriptor_sym = dlsym(handle, STRINGIZE(V8PP_PLUGIN_DESCRIPTOR_PROC_NAME));
+	void* init_sym = dlsym(handle, STRINGIZE(V8PP_PLUGIN_INIT_PROC_NAME));
+#endif
+	if (descriptor_sym)
+	{
+		p.descriptor = reinterpret_cast<descriptor_proc>(descriptor_sym)();
+		p.error = p.descriptor ? check_descriptor(*p.descriptor) : "empty plugin descriptor";
+		if (!p.error.empty())
+		{
+			p.descriptor = nullptr;
+			p.error += " in " + p.filename;
+		}
+	}
+	else if (!init_sym)
+	{
+		p.error = "initialization function " STRINGIZE(V8PP_PLUGIN_INIT_PROC_NAME) " not found in " + p.filename;
+	}
+
+	if (!p.error.empty())
+	{
+		unload(handle);
+		return;
+	}
+
+	p.init = reinterpret_cast<init_proc>(init_sym);
+	p.handle = handle;
+}
+
+void plugin_manager::unload(void* handle)
+{
+#if defined(WIN32)
+	::FreeLibrary((HMODULE)handle);
+#else
+	dlclose(handle);
+#endif
+}
+
+std::string plugin_manager::check_descriptor(plugin_descriptor const& descriptor)
+{
+	if (descriptor.abi_version != V8PP_PLUGIN_ABI_VERSION)
+	{
+		return "incompatible plugin ABI version " + std::to_string(descriptor.abi_version)
+			+ ", expected " + std::to_string(V8PP_PLUGIN_ABI_VERSION);
+	}
+	if (descriptor.v8_major_version != V8_MAJOR_VERSION || descriptor.v8_minor_version != V8_MINOR_VERSION)
+	{
+		return "plugin compiled with V8 " + std::to_string(descriptor.v8_major_version)
+			+ "." + std::to_string(descriptor.v8_minor_version) + ", expected "
+			STRINGIZE(V8_MAJOR_VERSION) "." STRINGIZE(V8_MINOR_VERSION);
+	}
+	if (descriptor.required_capabilities & ~plugin_host_capabilities)
+	{
+		return "plugin requires unsupported capabilities " + std::to_string(
+			descriptor.required_capabilities & ~plugin_host_capabilities);
+	}
+	return std::string();
+}
+
+v8::Local<v8::Value> plugin_manager::create_exports(plugin const& p)
+{
+	if (!p.descriptor)
+	{
+		return p.init(isolate_);
+	}
+
+	// export table is registered once in the isolate, each instance gets own functions
+	object_template& templ = export_templates_[p.name];
+	if (templ.IsEmpty())
+	{
+		v8::Local<v8::ObjectTemplate> obj = v8::ObjectTemplate::New(isolate_);
+		for (size_t i = 0; i < p.descriptor->export_count; ++i)
+		{
+			plugin_export const& entry = p.descriptor->exports[i];
+			detail::set_lazy_property<detail::lazy_plugin_function>(obj,
+				v8pp::to_v8(isolate_, entry.name), detail::set_external_data(isolate_, &entry));
+		}
+		templ.Reset(isolate_, obj);
+	}
+	return to_local(isolate_, templ)->NewInstance();
+}
+
+size_t plugin_manager::preload(size_t thread_count)
+{
+	std::vector<plugin*> pending;
+	for (auto& kv : plugins_)
+	{
+		if (!kv.second.handle)
+		{
+			pending.push_back(&kv.second);
+		}
+	}
+
+	if (thread_count == 0)
+	{
+		thread_count = std::thread::hardware_concurrency();
+	}
+	thread_count = std::min(std::max<size_t>(thread_count, 1), pending.size());
+
+	std::atomic<size_t> next(0);
+	auto worker = [this, &pending, &next]()
+	{
+		for (size_t i = next++; i < pending.size(); i = next++)
+		{
+			load(*pending[i], lib_path_, bind_now_);
+		}
+	};
+
+	std::vector<std::thread> threads;
+	threads.reserve(thread_count);
+	for (size_t i = 0; i < thread_count; ++i)
+	{
+		threads.emplace_back(worker);
+	}
+	for (std::thread& thread : threads)
+	{
+		thread.join();
+	}
+
+	return std::count_if(pending.begin(), pending.end(),
+		[](plugin const* p) { return p->handle != nullptr; });
+}
+
+std::vector<plugin_manager::plugin const*> plugin_manager::resolve(std::string const& name)
+{
+	return resolve(name, lib_path_);
+}
+
+std::vector<plugin_manager::plugin const*> plugin_manager::resolve(std::string const& name, std::string const& lib_path)
+{
+	std::vector<plugin const*> order;
+	std::vector<std::string> path;
+	resolve(declare(name), lib_path, order, path);
+	return order;
+}
+
+void plugin_manager::resolve(plugin& p, std::string const& lib_path,
+	std::vector<plugin const*>& order, std::vector<std::string>& path)
+{
+	if (std::find(order.begin(), order.end(), &p) != order.end())
+	{
+		return;
+	}
+
+	if (std::find(path.begin(), path.end(), p.name) != path.end())
+	{
+		std::string cycle;
+		for (std::string const& name : path)
+		{
+			cycle += name + " -> ";
+		}
+		throw std::runtime_error("plugin dependency cycle: " + cycle + p.name);
+	}
+
+	path.push_back(p.name);
+	for (std::string const& dependency : p.depends)
+	{
+		resolve(declare(dependency), lib_path, order, path);
+	}
+	path.pop_back();
+
+	load(p, lib_path, bind_now_);
+	if (!p.handle)
+	{
+		throw std::runtime_error("plugin " + p.name + ": " + p.error);
+	}
+	order.push_back(&p);
+}
+
+} // namespace v8pp
@@ -0,0 +1,133 @@
+#ifndef V8PP_PLUGIN_MANAGER_HPP_INCLUDED
+#define V8PP_PLUGIN_MANAGER_HPP_INCLUDED
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include <v8.h>
+
+#include "v8pp/config.hpp"
+#include "v8pp/plugin_descriptor.hpp"
+
+namespace v8pp {
+
+/// Shared library plugins of an isolate. Contexts on the isolate share
+/// loaded libraries, each context runs plugin initialization once
+/// on `require` and keeps own exports.
+/// Declared plugins can be opened in parallel on background threads
+/// with preload(), initialization always runs on the isolate thread.
+/// A plugin either exports V8PP_PLUGIN_DESCRIPTOR with a function table,
+/// checked for compatibility on load, or V8PP_PLUGIN_INIT procedure.
+class plugin_manager
+{
+public:
+	using init_proc = v8::Handle<v8::Value>(*)(v8::Isolate*);
+
+	struct plugin
+	{
+		std::string name;
+		std::string filename;
+		std::vector<std::string> depends;
+		void* handle;         ///< loaded library, nullptr if not loaded yet or failed
+		plugin_descriptor const* descriptor; ///< descriptor in the library, if any
+		init_proc init;       ///< V8PP_PLUGIN_INIT_PROC_NAME function in the library
+		std::string error;    ///< why the library could not be loaded
+
+		plugin()
+			: handle(nullptr)
+			, descriptor(nullptr)
+			, init(nullptr)
+		{
+		}
+	};
+
+	/// Plugin manager of the isolate, nullptr if there is no one
+	static plugin_manager* get(v8::Isolate* isolate)
+	{
+		return static_cast<plugin_manager*>(isolate->GetData(V8PP_PLUGIN_MANAGER_DATA_SLOT));
+	}
+
+	/// Plugin manager of the isolate, created on first use
+	static plugin_manager& instance(v8::Isolate* isolate);
+
+	/// Delete plugin manager of the isolate and unload its libraries,
+	/// called by context on isolate disposal
+	static void remove(v8::Isolate* isolate);
+
+	plugin_manager(plugin_manager const&) = delete;
+	plugin_manager& operator=(plugin_manager const&) = delete;
+
+	/// Library search path, used when a context has no own library path
+	std::string const& lib_path() const { return lib_path_; }
+	void set_lib_path(std::string const& lib_path) { lib_path_ = lib_path; }
+
+	/// Resolve all library symbols on load (RTLD_NOW) to report
+	/// missing ones before the plugin is used, off by default
+	bool bind_now() const { return bind_now_; }
+	void set_bind_now(bool value) { bind_now_ = value; }
+
+	/// Declare plugin with names of plugins it depends on,
+	/// dependencies are initialized before the plugin
+	plugin_manager& add(std::string const& name,
+		std::vector<std::string> const& depends = std::vector<std::string>());
+
+	/// Load declared plugins on thread_count background threads,
+	/// one per hardware thread for 0. Returns number of loaded plugins,
+	/// load errors are kept in the plugins until the next load attempt
+	size_t preload(size_t thread_count = 0);
+
+	/// Plugin with its dependencies in initialization order, the plugin is last.
+	/// Undeclared plugins are added without dependencies, libraries are loaded
+	/// if not preloaded, failed loads are retried. Throws std::runtime_error
+	/// on load failure or dependency cycle.
+	std::vector<plugin const*> resolve(std::string const& name);
+
+	/// Resolve plugin with libraries not loaded yet searched in lib_path.
+	/// Libraries are shared by the isolate contexts, a plugin loaded from
+	/// one path is not loaded again from another one
+	std::vector<plugin const*> resolve(std::string const& name, std::string const& lib_path);
+
+	/// Create exports of a resolved plugin in the current context. Exported
+	/// functions of a descriptor table are created on first access,
+	/// otherwise the plugin init procedure is called
+	v8::Local<v8::Value> create_exports(plugin const& p);
+
+	/// Error message for a descriptor incompatible with the host, empty if compatible
+	static std::string check_descriptor(plugin_descriptor const& descriptor);
+
+	/// Load library of the plugin p.name from lib_path, with the plugin suffix
+	/// added to the name without it, if it's not loaded yet. Sets the library
+	/// entry points or p.error, touches only the plugin so different plugins
+	/// can be loaded concurrently
+	static void load(plugin& p, std::string const& lib_path, bool bind_now);
+
+	/// Unload library loaded by load()
+	static void unload(void* handle);
+
+	/// Declared plugin, nullptr if there is no plugin with such name
+	plugin const* find(std::string const& name) const;
+
+	/// Number of declared plugins
+	size_t size() const { return plugins_.size(); }
+
+private:
+	explicit plugin_manager(v8::Isolate* isolate);
+	~plugin_manager();
+
+	plugin& declare(std::string const& name);
+	void resolve(plugin& p, std::string const& lib_path,
+		std::vector<plugin const*>& order, std::vector<std::string>& path);
+
+	using object_template = v8::Persistent<v8::ObjectTemplate, v8::CopyablePersistentTraits<v8::ObjectTemplate>>;
+
+	v8::Isolate* isolate_;
+	std::string lib_path_;
+	bool bind_now_;
+	std::map<std::string, plugin> plugins_;
+	std::map<std::string, object_template> export_templates_;
+};
+
+} // namespace v8pp
+
+#endif // V8PP_PLUGIN_MANAGER_HPP_INCLUDED
@@ -0,0 +1,165 @@
+#include "v8pp/profiler.hpp"
+
+#include <sstream>
+
+namespace v8pp {
+
+size_t const profiler::histogram_size;
+
+profiler::profiler()
+	: enabled_(false)
+	, current_(nullptr)
+{
+}
+
+profiler& profiler::instance(v8::Isolate* isolate)
+{
+	profiler* result = get(isolate);
+	if (!result)
+	{
+		result = new profiler;
+		isolate->SetData(V8PP_PROFILER_DATA_SLOT, result);
+	}
+	return *result;
+}
+
+void profiler::enable(v8::Isolate* isolate, bool value)
+{
+	if (value || get(isolate))
+	{
+		instance(isolate).enabled_ = value;
+	}
+}
+
+void profiler::remove(v8::Isolate* isolate)
+{
+	delete get(isolate);
+	isolate->SetData(V8PP_PROFILER_DATA_SLOT, nullptr);
+}
+
+void profiler::name_binding(v8::Isolate* isolate, v8::Handle<v8::Value> data, void const* group, char const* name)
+{
+	if (!data.IsEmpty() && data->IsExternal())
+	{
+		binding_name& binding = instance(isolate).names_[data.As<v8::External>()->Value()];
+		binding.group = group;
+		binding.name = name;
+	}
+}
+
+void profiler::name_group(v8::Isolate* isolate, void const* group, char const* name)
+{
+	instance(isolate).groups_[group] = name;
+}
+
+std::string profiler::full_name(void const* key) const
+{
+	auto name = names_.find(key);
+	if (name == names_.end())
+	{
+		std::ostringstream os;
+		os << "<anonymous " << key << '>';
+		return os.str();
+	}
+
+	std::string result;
+	if (name->second.group)
+	{
+		auto group = groups_.find(name->second.group);
+		result = (group != groups_.end() ? group->second : "<class>");
+		result += '.';
+	}
+	result += name->second.name;
+	return result;
+}
+
+char const* profiler::operation_name(operation op)
+{
+	switch (op)
+	{
+	case op_call: return "call";
+	case op_get: return "get";
+	case op_set: return "set";
+	case op_enumerate: return "enumerate";
+	case op_query: return "query";
+	case op_delete: return "delete";
+	}
+	return "";
+}
+
+static void write_json_string(std::ostream& os, std::string const& str)
+{
+	os << '"';
+	for (char c : str)
+	{
+		switch (c)
+		{
+		case '"': os << "\\\""; break;
+		case '\\': os << "\\\\"; break;
+		case '\n': os << "\\n"; break;
+		default:
+			if (static_cast<unsigned char>(c) < 0x20)
+			{
+				os << "\\u00" << "0123456789abcdef"[c >> 4] << "0123456789abcdef"[c & 0xF];
+			}
+			else
+			{
+				os << c;
+			}
+		}
+	}
+	os << '"';
+}
+
+std::string profiler::to_json() const
+{
+	std::ostringstream os;
+	os << '[';
+	bool first = true;
+	for (auto const& item : records_)
+	{
+		record const& rec = item.second;
+
+		os << (first ? "\n" : ",\n") << "{\"name\":";
+		write_json_string(os, full_name(item.first.first));
+		os << ",\"operation\":\"" << operation_name(item.first.second) << '"'
+			<< ",\"calls\":" << rec.calls
+			<< ",\"total_ns\":" << rec.total_ns
+			<< ",\"convert_ns\":" << rec.convert_ns
+			<< ",\"body_ns\":" << (rec.total_ns - rec.convert_ns)
+			<< ",\"histogram\":[";
+		// trailing empty buckets are omitted
+		size_t last = histogram_size;
+		while (last > 0 && rec.histogram[last - 1] == 0)
+		{
+			--last;
+		}
+		for (size_t i = 0; i < last; ++i)
+		{
+			os << (i ? "," : "") << rec.histogram[i];
+		}
+		os << "]}";
+		first = false;
+	}
+	os << "\n]\n";
+	return os.str();
+}
+
+std::string profiler::to_folded() const
+{
+	std::ostringstream os;
+	for (auto const& item : records_)
+	{
+		std::string name = full_name(item.first.first);
+		for (char& c : name)
+		{
+			if (c == '.') c = ';';
+			else if (c == ' ') c = '_';
+		}
+		os << name << ';' << operation_name(item.first.second)
+			<< ' ' << (item.second.total_ns / 1000) << '\n';
+	}
+	return os.str();
+}
+
+} // namespace v8pp
@@ -0,0 +1,230 @@
+#ifndef V8PP_PROFILER_HPP_INCLUDED
+#define V8PP_PROFILER_HPP_INCLUDED
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include <v8.h>
+
+#include "v8pp/config.hpp"
+
+namespace v8pp {
+
+namespace detail {
+	class profile_call;
+	class profile_convert;
+} // namespace detail
+
+/// Per-binding call statistics of an isolate.
+/// Calls are recorded only when the library is compiled with V8PP_ENABLE_PROFILER
+/// defined and profiling is enabled for the isolate with profiler::enable().
+/// Without V8PP_ENABLE_PROFILER the binding code has no instrumentation at all.
+class profiler
+{
+public:
+	/// Kind of a binding callback
+	enum operation
+	{
+		op_call,
+		op_get,
+		op_set,
+		op_enumerate,
+		op_query,
+		op_delete,
+	};
+
+	static size_t const histogram_size = 32;
+
+	struct record
+	{
+		uint64_t calls;
+		uint64_t total_ns;    ///< inclusive call time
+		uint64_t convert_ns;  ///< time spent in argument conversion
+		uint64_t histogram[histogram_size]; ///< number of calls by log2 of inclusive time in nanoseconds
+	};
+
+	/// Profiler of the isolate, nullptr if there are no bindings
+	/// named for profiling and profiling was never enabled
+	static profiler* get(v8::Isolate* isolate)
+	{
+		return static_cast<profiler*>(isolate->GetData(V8PP_PROFILER_DATA_SLOT));
+	}
+
+	/// Start or stop call recording in the isolate
+	static void enable(v8::Isolate* isolate, bool value);
+
+	/// Delete profiler of the isolate, called by context on isolate disposal
+	static void remove(v8::Isolate* isolate);
+
+	/// Set name for callback data of a binding, group is an owner key like class type
+	static void name_binding(v8::Isolate* isolate, v8::Handle<v8::Value> data, void const* group, char const* name);
+
+	/// Set name for a group of bindings
+	static void name_group(v8::Isolate* isolate, void const* group, char const* name);
+
+	bool enabled() const { return enabled_; }
+
+	/// Clear recorded statistics, binding names are kept
+	void reset() { records_.clear(); }
+
+	/// Statistics as JSON array of objects with
+	/// name, operation, calls, total_ns, convert_ns, body_ns and histogram fields
+	std::string to_json() const;
+
+	/// Statistics in folded stack format `group;name;operation total_us` one per line,
+	/// ready for flame graph tools and pprof converters
+	std::string to_folded() const;
+
+private:
+	friend class detail::profile_call;
+	friend class detail::profile_convert;
+
+	using record_key = std::pair<void const*, operation>;
+
+	struct record_key_hash
+	{
+		size_t operator()(record_key const& key) const
+		{
+			return std::hash<void const*>()(key.first) * 31 + key.second;
+		}
+	};
+
+	struct binding_name
+	{
+		void const* group;
+		std::string name;
+	};
+
+	profiler();
+
+	static profiler& instance(v8::Isolate* isolate);
+
+	std::string full_name(void const* key) const;
+	static char const* operation_name(operation op);
+
+	bool enabled_;
+	detail::profile_call* current_;
+
+	std::unordered_map<record_key, record, record_key_hash> records_;
+	std::unordered_map<void const*, binding_name> names_;
+	std::unordered_map<void const*, std::string> groups_;
+};
+
+#if defined(V8PP_ENABLE_PROFILER)
+
+namespace detail {
+
+/// Measures inclusive time of a binding callback
+class profile_call
+{
+public:
+	profile_call(v8::Isolate* isolate, v8::Handle<v8::Value> data, profiler::operation op)
+		: profiler_(profiler::get(isolate))
+	{
+		if (profiler_ && profiler_->enabled_)
+		{
+			key_ = profiler::record_key(data.As<v8::External>()->Value(), op);
+			convert_ns_ = 0;
+			parent_ = profiler_->current_;
+			profiler_->current_ = this;
+			start_ = std::chrono::steady_clock::now();
+		}
+		else
+		{
+			profiler_ = nullptr;
+		}
+	}
+
+	~profile_call()
+	{
+		if (profiler_)
+		{
+			uint64_t const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - start_).count();
+
+			profiler::record& rec = profiler_->records_[key_];
+			++rec.calls;
+			rec.total_ns += ns;
+			rec.convert_ns += convert_ns_;
+
+			size_t bucket = 0;
+			for (uint64_t n = ns; n > 1 && bucket < profiler::histogram_size - 1; n >>= 1)
+			{
+				++bucket;
+			}
+			++rec.histogram[bucket];
+
+			profiler_->current_ = parent_;
+		}
+	}
+
+	profile_call(profile_call const&) = delete;
+	profile_call& operator=(profile_call const&) = delete;
+
+private:
+	friend class profile_convert;
+
+	profiler* profiler_;
+	profile_call* parent_;
+	profiler::record_key key_;
+	uint64_t convert_ns_;
+	std::chrono::steady_clock::time_point start_;
+};
+
+/// Measures argument conversion time in the current binding callback
+class profile_convert
+{
+public:
+	explicit profile_convert(v8::Isolate* isolate)
+	{
+		profiler* p = profiler::get(isolate);
+		call_ = p ? p->current_ : nullptr;
+		if (call_)
+		{
+			start_ = std::chrono::steady_clock::now();
+		}
+	}
+
+	~profile_convert()
+	{
+		if (call_)
+		{
+			call_->convert_ns_ += std::chrono::duration_cast<std::chrono::nanoseconds>(
+				std::chrono::steady_clock::now() - start_).count();
+		}
+	}
+
+	profile_convert(profile_convert const&) = delete;
+	profile_convert& operator=(profile_convert const&) = delete;
+
+private:
+	profile_call* call_;
+	std::chrono::steady_clock::time_point start_;
+};
+
+} // namespace detail
+
+#define V8PP_PROFILE_CALL(isolate, data, op) \
+	::v8pp::detail::profile_call v8pp_profile_call_(isolate, data, ::v8pp::profiler::op)
+#define V8PP_PROFILE_CONVERT(isolate) \
+	::v8pp::detail::profile_convert v8pp_profile_convert_(isolate)
+#define V8PP_PROFILE_NAME(isolate, data, group, name) \
+	::v8pp::profiler::name_binding(isolate, data, group, name)
+#define V8PP_PROFILE_GROUP(isolate, group, name) \
+	::v8pp::profiler::name_group(isolate, group, name)
+
+#else
+
+#define V8PP_PROFILE_CALL(isolate, data, op)
+#define V8PP_PROFILE_CONVERT(isolate)
+#define V8PP_PROFILE_NAME(isolate, data, group, name)
+#define V8PP_PROFILE_GROUP(isolate, group, name)
+
+#endif // V8PP_ENABLE_PROFILER
+
+} // namespace v8pp
+
+#endif // V8PP_PROFILER_HPP_INCLUDED
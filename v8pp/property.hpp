@@ -80,6 +80,7 @@ using is_interceptor = std::integral_constant<bool,
 	call_from_v8_traits<F>::arg_count == 1 &&
 	(std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, std::string>::value 
 	|| std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, const char *> ::value
+	|| std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, string_view>::value
 	|| std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, unsigned int>::value
 	|| std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, int>::value)
 	&&
@@ -91,6 +92,7 @@ using is_interceptor_pointer = std::integral_constant < bool,
 	call_from_v8_traits<F>::arg_count == 1 &&
 	(std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, std::string> ::value ||
 	std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, const char *> ::value ||
+	std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, string_view>::value ||
 	std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, unsigned int>::value ||
 	std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, int>::value) &&
 	is_pointer_return<F>::value
@@ -142,6 +144,7 @@ using is_setter_interceptor = std::integral_constant<bool,
 	(std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, std::string>::value
 	|| std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, std::wstring>::value
 	|| std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, const char*>::value
+	|| std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, string_view>::value
 	|| std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, const wchar_t*>::value
 	|| std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, int>::value
 	|| std::is_same<typename call_from_v8_traits<F>::template arg_type<0>, unsigned int>::value
@@ -346,6 +349,7 @@ struct r_property_impl<Get, Set, true>
 	static void get(F name, v8::PropertyCallbackInfo<v8::Value> const& info)
 	{
 		v8::Isolate* isolate = info.GetIsolate();
+		V8PP_PROFILE_CALL(isolate, info.Data(), op_get);
 
 		class_type& obj = v8pp::from_v8<class_type&>(isolate, info.This());
 
@@ -402,6 +406,7 @@ struct r_property_impl<Get, Set, false>
 	{
 		v8::Isolate* isolate = info.GetIsolate();
 
+		V8PP_PROFILE_CALL(isolate, info.Data(), op_get);
 		Property prop = detail::get_external_data<Property>(info.Data());
 		assert(prop.get_);
 
@@ -460,6 +465,7 @@ struct rw_property_impl<Get, Set, true>
 	static void set(Index_or_name name, v8::Local<v8::Value> value, v8::PropertyCallbackInfo<void> const& info)
 	{
 		v8::Isolate* isolate = info.GetIsolate();
+		V8PP_PROFILE_CALL(isolate, info.Data(), op_set);
 
 		class_type& obj = v8pp::from_v8<class_type&>(isolate, info.This());
 
@@ -515,6 +521,7 @@ struct rw_property_impl<Get, Set, false>
 	{
 		v8::Isolate* isolate = info.GetIsolate();
 
+		V8PP_PROFILE_CALL(isolate, info.Data(), op_set);
 		Property prop = detail::get_external_data<Property>(info.Data());
 		assert(prop.set_);
 
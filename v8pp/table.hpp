@@ -0,0 +1,184 @@
+#ifndef V8PP_TABLE_HPP_INCLUDED
+#define V8PP_TABLE_HPP_INCLUDED
+
+#include <v8.h>
+
+#include "v8pp/class.hpp"
+#include "v8pp/indexed_storage.hpp"
+
+namespace v8pp {
+
+namespace detail {
+
+/// Row proxy of a table: a plain object with the table object and a row
+/// index in internal fields, without registration in the class objects
+struct table_row
+{
+	using object_template = v8::UniquePersistent<v8::ObjectTemplate>;
+
+	static int const table_field = 0;
+	static int const index_field = 1;
+	// wrapped objects have 2 or 3 internal fields with a wrapper_header,
+	// a row has more fields to be never unwrapped as a C++ object
+	static int const field_count = 4;
+
+	static uint32_t index(v8::Local<v8::Object> row)
+	{
+		return row->GetInternalField(index_field)->Uint32Value();
+	}
+
+	static void get_index(v8::Local<v8::String>, v8::PropertyCallbackInfo<v8::Value> const& info)
+	{
+		info.GetReturnValue().Set(info.Holder()->GetInternalField(index_field));
+	}
+
+	static void set_index(v8::Local<v8::String>, v8::Local<v8::Value> value, v8::PropertyCallbackInfo<void> const& info)
+	{
+		info.Holder()->SetInternalField(index_field,
+			v8::Integer::NewFromUnsigned(info.GetIsolate(), value->Uint32Value()));
+	}
+
+	/// table.row(index) returns a new row proxy
+	static void create(v8::FunctionCallbackInfo<v8::Value> const& args)
+	{
+		v8::Isolate* isolate = args.GetIsolate();
+		object_template const* templ = get_external_data<object_template const*>(args.Data());
+
+		v8::Local<v8::Object> row = to_local(isolate, *templ)->NewInstance();
+		row->SetInternalField(table_field, args.This());
+		row->SetInternalField(index_field, v8::Integer::NewFromUnsigned(isolate, args[0]->Uint32Value()));
+		args.GetReturnValue().Set(row);
+	}
+};
+
+/// Column value of a table row, undefined for a row out of the column range
+template<typename Data, typename Size>
+void table_row_get(v8::Local<v8::String>, v8::PropertyCallbackInfo<v8::Value> const& info)
+{
+	using column_type = indexed_storage<Data, Size>;
+	using pure_class = typename column_type::pure_class;
+
+	v8::Isolate* isolate = info.GetIsolate();
+	v8::Local<v8::Object> row = info.Holder();
+	pure_class* obj = class_<pure_class>::unwrap_this(isolate,
+		row->GetInternalField(table_row::table_field).As<v8::Object>());
+	if (obj)
+	{
+		column_type const& column = get_external_data<column_type>(info.Data());
+		uint32_t const index = table_row::index(row);
+		if (index < static_cast<size_t>((obj->*column.size)()))
+		{
+			set_element(info.GetReturnValue(), isolate, (obj->*column.data)()[index],
+				select_element_tag<typename column_type::value_type>());
+		}
+	}
+}
+
+/// Number of rows in a table
+template<typename Size>
+void table_length_get(v8::Local<v8::String>, v8::PropertyCallbackInfo<v8::Value> const& info)
+{
+	using class_type = typename std::tuple_element<0,
+		typename function_traits<Size>::arguments>::type;
+	using pure_class = typename remove_all<class_type>::type;
+
+	pure_class* obj = class_<pure_class>::unwrap_this(info.GetIsolate(), info.This());
+	if (obj)
+	{
+		Size size = get_external_data<Size>(info.Data());
+		info.GetReturnValue().Set(static_cast<double>((obj->*size)()));
+	}
+}
+
+} // namespace detail
+
+/// Columnar table binding for wrapped C++ class T with column stores.
+/// The table object gets typed array columns, `length` with the number
+/// of rows and `row(index)` function returning a row proxy. A row proxy
+/// reads column values of the row by name and has writable `index`,
+/// so one proxy can scan the whole table:
+///
+///     r = t.row(0); for (i = 0; i < t.length; ++i) { r.index = i; sum += r.price; }
+///
+/// Row proxies are plain objects referencing the table object, no wrapper
+/// is created for a row. Columns should be added before the first row is created.
+template<typename T>
+class table_
+{
+public:
+	/// Table binding of the class, rows is T member function with number of rows
+	template<typename Size>
+	table_(class_<T>& cl, Size rows)
+		: cl_(cl)
+		, isolate_(cl.isolate())
+	{
+		v8::HandleScope scope(isolate_);
+
+		v8::Local<v8::ObjectTemplate> row = v8::ObjectTemplate::New(isolate_);
+		row->SetInternalFieldCount(detail::table_row::field_count);
+		row->SetAccessor(v8pp::to_v8(isolate_, "index"), &detail::table_row::get_index,
+			&detail::table_row::set_index, v8::Local<v8::Value>(), v8::DEFAULT, v8::DontDelete);
+
+		row_ = new row_template(isolate_, row);
+		v8::Local<v8::Value> data = detail::external_info::emplace_data(isolate_,
+			row_, &detail::delete_object_callback<row_template>);
+
+		// installed with the class bindings, the class templates are not created here
+		class_singleton& singleton = class_singleton::instance(isolate_);
+		singleton.add_binding(&install_row, "row", data);
+		singleton.add_data_binding(&install_length<Size>, "length", rows,
+			v8::PropertyAttribute(v8::ReadOnly | v8::DontDelete));
+	}
+
+	/// v8::Isolate where the table bindings belongs
+	v8::Isolate* isolate() { return isolate_; }
+
+	/// Add column with arithmetic elements (obj.*data)() and (obj.*size)() length:
+	/// a typed array property in the table object and a read-only row proxy property
+	template<typename Data, typename Size>
+	table_& column(char const* name, Data data, Size size)
+	{
+		using column_type = detail::indexed_storage<Data, Size>;
+
+		cl_.set_typed_array(name, data, size);
+
+		v8::HandleScope scope(isolate_);
+
+		column_type column;
+		column.data = data;
+		column.size = size;
+		column.read_only = true;
+
+		to_local(isolate_, *row_)->SetAccessor(v8pp::to_v8(isolate_, name), &detail::table_row_get<Data, Size>,
+			nullptr, detail::set_external_data(isolate_, column), v8::DEFAULT, v8::PropertyAttribute(v8::ReadOnly | v8::DontDelete));
+		return *this;
+	}
+
+private:
+	using row_template = detail::table_row::object_template;
+	using class_singleton = detail::class_singleton<T>;
+	using binding = typename class_singleton::binding;
+
+	static void install_row(class_singleton& singleton, binding const& b, v8::Local<v8::Value> data)
+	{
+		v8::Isolate* isolate = singleton.isolate();
+		singleton.class_function_template()->PrototypeTemplate()->Set(v8pp::to_v8(isolate, b.name),
+			v8::FunctionTemplate::New(isolate, &detail::table_row::create, data));
+	}
+
+	template<typename Size>
+	static void install_length(class_singleton& singleton, binding const& b, v8::Local<v8::Value> data)
+	{
+		v8::Isolate* isolate = singleton.isolate();
+		singleton.class_function_template()->PrototypeTemplate()->SetAccessor(v8pp::to_v8(isolate, b.name),
+			&detail::table_length_get<Size>, nullptr, data, v8::DEFAULT, b.attrs);
+	}
+
+	class_<T>& cl_;
+	v8::Isolate* isolate_;
+	row_template* row_; // owned by the isolate external data
+};
+
+} // namespace v8pp
+
+#endif // V8PP_TABLE_HPP_INCLUDED
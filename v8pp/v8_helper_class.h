@@ -1,9 +1,16 @@
 #pragma once;
 
 #include <v8pp/convert.hpp>
+#include <v8pp/lazy_property.hpp>
 
 namespace v8pp
 {
+	namespace detail
+	{
+		template<typename T>
+		struct lazy_class_function;
+	}
+
 	//for easily adding values to a v8::object
 	class v8_object_helper
 	{
@@ -21,13 +28,14 @@ namespace v8pp
 			return *this;
 		}
 
-		/// Set class to the object
+		/// Set class to the object, the constructor function is created on first access
 		template<typename T>
 		v8_object_helper& set(char const* name, class_<T>& cl)
 		{
 			v8::HandleScope scope(isolate_);
 			cl.set_class_name(name, isolate_);
-			return set(name, cl.js_function_template()->GetFunction());
+			detail::set_lazy_property<detail::lazy_class_function<T>>(object_, to_v8(isolate_, name));
+			return *this;
 		}
 
 	private:
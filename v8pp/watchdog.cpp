@@ -0,0 +1,203 @@
+#include "v8pp/watchdog.hpp"
+
+#include <algorithm>
+#include <memory>
+
+#if defined(WIN32)
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <time.h>
+#endif
+
+namespace v8pp {
+
+namespace {
+
+// CPU time consumed by the calling thread, readable from another thread
+std::function<watchdog::clock::duration()> current_thread_cpu_clock()
+{
+	using duration = watchdog::clock::duration;
+#if defined(WIN32)
+	HANDLE handle = nullptr;
+	::DuplicateHandle(::GetCurrentProcess(), ::GetCurrentThread(), ::GetCurrentProcess(),
+		&handle, 0, FALSE, DUPLICATE_SAME_ACCESS);
+	std::shared_ptr<void> thread(handle, ::CloseHandle);
+	return [thread]()
+	{
+		FILETIME creation, exit, kernel, user;
+		if (!::GetThreadTimes(thread.get(), &creation, &exit, &kernel, &user))
+		{
+			return duration::zero();
+		}
+		uint64_t const kernel_time = (uint64_t(kernel.dwHighDateTime) << 32) | kernel.dwLowDateTime;
+		uint64_t const user_time = (uint64_t(user.dwHighDateTime) << 32) | user.dwLowDateTime;
+		// FILETIME is in 100 nanosecond units
+		return std::chrono::duration_cast<duration>(
+			std::chrono::nanoseconds((kernel_time + user_time) * 100));
+	};
+#else
+	clockid_t clock_id;
+	if (pthread_getcpuclockid(pthread_self(), &clock_id) != 0)
+	{
+		// no thread CPU clock, count wall time instead
+		return []() { return watchdog::clock::now().time_since_epoch(); };
+	}
+	return [clock_id]()
+	{
+		timespec ts;
+		if (clock_gettime(clock_id, &ts) != 0)
+		{
+			return duration::zero();
+		}
+		return std::chrono::duration_cast<duration>(
+			std::chrono::seconds(ts.tv_sec) + std::chrono::nanoseconds(ts.tv_nsec));
+	};
+#endif
+}
+
+} // unnamed namespace
+
+watchdog& watchdog::instance()
+{
+	static watchdog instance_;
+	return instance_;
+}
+
+watchdog::watchdog()
+	: stopped_(false)
+	, next_ticket_(0)
+{
+	thread_ = std::thread(&watchdog::run, this);
+}
+
+watchdog::~watchdog()
+{
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		stopped_ = true;
+	}
+	wakeup_.notify_one();
+	thread_.join();
+}
+
+watchdog::ticket watchdog::arm(v8::Isolate* isolate, clock::duration wall_time, clock::duration cpu_time)
+{
+	entry e;
+	e.isolate = isolate;
+	e.wall_deadline = wall_time > clock::duration::zero() ? clock::now() + wall_time : clock::time_point::max();
+	e.cpu_budget = cpu_time > clock::duration::zero() ? cpu_time : clock::duration::zero();
+	if (e.cpu_budget != clock::duration::zero())
+	{
+		e.cpu_time = current_thread_cpu_clock();
+		e.cpu_start = e.cpu_time();
+	}
+	e.fired = false;
+
+	ticket id;
+	bool earliest;
+	{
+		std::lock_guard<std::mutex> lock(mutex_);
+		id = ++next_ticket_;
+		entry const& inserted = entries_.emplace(id, std::move(e)).first->second;
+		schedule(id, inserted, clock::now());
+		earliest = (checks_.front().id == id);
+	}
+	if (earliest)
+	{
+		wakeup_.notify_one();
+	}
+	return id;
+}
+
+bool watchdog::disarm(ticket t)
+{
+	// check point of the ticket is dropped lazily in run()
+	std::lock_guard<std::mutex> lock(mutex_);
+	auto it = entries_.find(t);
+	if (it == entries_.end())
+	{
+		return false;
+	}
+	bool const fired = it->second.fired;
+	entries_.erase(it);
+
+	// many short runs with long budgets leave a lot of stale check points
+	if (checks_.size() > 64 && checks_.size() > 2 * entries_.size())
+	{
+		checks_.erase(std::remove_if(checks_.begin(), checks_.end(),
+			[this](check_point const& cp) { return entries_.find(cp.id) == entries_.end(); }),
+			checks_.end());
+		std::make_heap(checks_.begin(), checks_.end(), std::greater<check_point>());
+	}
+	return fired;
+}
+
+void watchdog::schedule(ticket id, entry const& e, clock::time_point now)
+{
+	clock::time_point when = e.wall_deadline;
+	if (e.cpu_budget != clock::duration::zero())
+	{
+		// a thread can't consume CPU time faster than wall time,
+		// so the budget can't run out before the remaining time passes
+		clock::duration const used = e.cpu_time() - e.cpu_start;
+		clock::duration const left = std::max(e.cpu_budget - used, clock::duration::zero());
+		when = std::min(when, now + left);
+	}
+
+	check_point const cp = { when, id };
+	checks_.push_back(cp);
+	std::push_heap(checks_.begin(), checks_.end(), std::greater<check_point>());
+}
+
+void watchdog::check(ticket id, entry& e, clock::time_point now)
+{
+	bool expired = (now >= e.wall_deadline);
+	if (!expired && e.cpu_budget != clock::duration::zero())
+	{
+		expired = (e.cpu_time() - e.cpu_start >= e.cpu_budget);
+	}
+
+	if (expired)
+	{
+		// under the lock, so disarm() always sees the termination
+		e.fired = true;
+		e.isolate->TerminateExecution();
+	}
+	else
+	{
+		schedule(id, e, now);
+	}
+}
+
+void watchdog::run()
+{
+	std::unique_lock<std::mutex> lock(mutex_);
+	while (!stopped_)
+	{
+		clock::time_point const now = clock::now();
+		while (!checks_.empty() && checks_.front().when <= now)
+		{
+			std::pop_heap(checks_.begin(), checks_.end(), std::greater<check_point>());
+			ticket const id = checks_.back().id;
+			checks_.pop_back();
+
+			auto it = entries_.find(id);
+			if (it != entries_.end() && !it->second.fired)
+			{
+				check(id, it->second, now);
+			}
+		}
+
+		if (checks_.empty())
+		{
+			wakeup_.wait(lock);
+		}
+		else
+		{
+			wakeup_.wait_until(lock, checks_.front().when);
+		}
+	}
+}
+
+} // namespace v8pp
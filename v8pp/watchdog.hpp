@@ -0,0 +1,89 @@
+#ifndef V8PP_WATCHDOG_HPP_INCLUDED
+#define V8PP_WATCHDOG_HPP_INCLUDED
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <v8.h>
+
+namespace v8pp {
+
+/// Single thread shared by all isolates, terminates script execution
+/// in an isolate when its time budget runs out.
+/// Arming and disarming only lock a mutex, no thread is created per call.
+class watchdog
+{
+public:
+	using clock = std::chrono::steady_clock;
+	using ticket = uint64_t;
+
+	/// Process wide watchdog instance, the thread starts on first use
+	static watchdog& instance();
+
+	~watchdog();
+
+	watchdog(watchdog const&) = delete;
+	watchdog& operator=(watchdog const&) = delete;
+
+	/// Terminate execution in the isolate after wall_time elapsed or after
+	/// the calling thread has consumed cpu_time, zero duration means no limit.
+	/// Returns ticket for disarm()
+	ticket arm(v8::Isolate* isolate, clock::duration wall_time, clock::duration cpu_time);
+
+	/// Remove the ticket, returns true if execution has been terminated for it
+	bool disarm(ticket t);
+
+private:
+	using cpu_clock = std::function<clock::duration()>;
+
+	struct entry
+	{
+		v8::Isolate* isolate;
+		clock::time_point wall_deadline;
+		clock::duration cpu_budget;
+		clock::duration cpu_start;
+		cpu_clock cpu_time;
+		bool fired;
+	};
+
+	struct check_point
+	{
+		clock::time_point when;
+		ticket id;
+
+		bool operator>(check_point const& other) const
+		{
+			return when > other.when || (when == other.when && id > other.id);
+		}
+	};
+
+	watchdog();
+
+	void run();
+
+	/// Schedule the next check of the entry, mutex_ must be locked
+	void schedule(ticket id, entry const& e, clock::time_point now);
+
+	/// Terminate execution or re-schedule the entry, mutex_ must be locked
+	void check(ticket id, entry& e, clock::time_point now);
+
+	std::mutex mutex_;
+	std::condition_variable wakeup_;
+	bool stopped_;
+
+	ticket next_ticket_;
+	std::vector<check_point> checks_;
+	std::map<ticket, entry> entries_;
+
+	std::thread thread_;
+};
+
+} // namespace v8pp
+
+#endif // V8PP_WATCHDOG_HPP_INCLUDED